@@ -0,0 +1,53 @@
+# Compares instruction counts in a disassembled object: every function unit_<name> must
+# have no more instructions than raw_<name>. Run as a script:
+#
+#   cmake -DOBJDUMP=<objdump> -DOBJECT=<object file> -P AsmCheck.cmake
+
+execute_process(COMMAND ${OBJDUMP} -d --no-show-raw-insn ${OBJECT}
+	OUTPUT_VARIABLE disassembly
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "${OBJDUMP} failed on ${OBJECT}")
+endif()
+
+# One list element per line
+string(REPLACE ";" "\;" disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(function "")
+set(functions "")
+foreach(line IN LISTS lines)
+	if(line MATCHES "^[0-9a-f]+ <([A-Za-z0-9_]+)>:$")
+		set(function ${CMAKE_MATCH_1})
+		set(count_${function} 0)
+		list(APPEND functions ${function})
+	# Count instructions, but not the alignment padding between functions
+	elseif(function AND line MATCHES "^ +[0-9a-f]+:\t" AND NOT line MATCHES "\t(cs )?(nop|data16|xchg +%ax,%ax)")
+		math(EXPR count_${function} "${count_${function}} + 1")
+	endif()
+endforeach()
+
+set(checked 0)
+set(failed 0)
+foreach(function IN LISTS functions)
+	if(function MATCHES "^unit_(.+)$")
+		set(raw raw_${CMAKE_MATCH_1})
+		if(NOT DEFINED count_${raw})
+			message(SEND_ERROR "${function} has no ${raw} to compare against")
+			math(EXPR failed "${failed} + 1")
+		elseif(count_${function} GREATER count_${raw})
+			message(SEND_ERROR "${function}: ${count_${function}} instructions, ${raw}: ${count_${raw}}")
+			math(EXPR failed "${failed} + 1")
+		else()
+			message(STATUS "${function}: ${count_${function}} instructions, ${raw}: ${count_${raw}}")
+		endif()
+		math(EXPR checked "${checked} + 1")
+	endif()
+endforeach()
+
+if(checked EQUAL 0)
+	message(FATAL_ERROR "No unit_ functions found in ${OBJECT}")
+endif()
+if(failed GREATER 0)
+	message(FATAL_ERROR "${failed} of ${checked} unit functions emit more instructions than raw code")
+endif()
@@ -0,0 +1,90 @@
+// Compile-time benchmark for Dim arithmetic. This isn't linked into anything: it's only
+// compiled, with -fsyntax-only, by the simpleunit_compile_bench target, which times it with
+// the packed Dim of Unit.h and with SUNIT_BENCH_UNPACKED_DIM defined, which compares against
+// the previous encoding of one int template parameter per dimension.
+
+// Both variants include Unit.h, so the difference is down to Dim alone.
+#include "simpleunit/Unit.h"
+
+#include <cstddef>
+#include <utility>
+
+#ifdef SUNIT_BENCH_UNPACKED_DIM
+
+// As Dim was: in namespace sunit, with its products and quotients found by overload resolution
+namespace sunit {
+
+template <int D1, int D2=0, int D3=0, int D4=0, int D5=0, int D6=0, int D7=0>
+struct UnpackedDim {
+	static constexpr int d1 = D1;
+	static constexpr int d2 = D2;
+	static constexpr int d3 = D3;
+	static constexpr int d4 = D4;
+	static constexpr int d5 = D5;
+	static constexpr int d6 = D6;
+	static constexpr int d7 = D7;
+};
+
+template <int A1, int A2, int A3, int A4, int A5, int A6, int A7,
+          int B1, int B2, int B3, int B4, int B5, int B6, int B7>
+constexpr UnpackedDim<A1+B1, A2+B2, A3+B3, A4+B4, A5+B5, A6+B6, A7+B7>
+operator*(UnpackedDim<A1,A2,A3,A4,A5,A6,A7>, UnpackedDim<B1,B2,B3,B4,B5,B6,B7>) { return {}; }
+
+template <int A1, int A2, int A3, int A4, int A5, int A6, int A7,
+          int B1, int B2, int B3, int B4, int B5, int B6, int B7>
+constexpr UnpackedDim<A1-B1, A2-B2, A3-B3, A4-B4, A5-B5, A6-B6, A7-B7>
+operator/(UnpackedDim<A1,A2,A3,A4,A5,A6,A7>, UnpackedDim<B1,B2,B3,B4,B5,B6,B7>) { return {}; }
+
+} // sunit
+
+namespace bench {
+	template <int... D>
+	using Dim = sunit::UnpackedDim<D...>;
+
+	template <typename D1, typename D2>
+	using DimMultiply = decltype(D1() * D2());
+
+	template <typename D1, typename D2>
+	using DimDivide = decltype(D1() / D2());
+}
+
+#else
+
+namespace bench {
+	using sunit::Dim;
+	using sunit::DimMultiply;
+	using sunit::DimDivide;
+}
+
+#endif
+
+namespace
+{
+	// Each index gives a distinct dimension, with exponents in [-2, 2]
+	template <std::size_t I>
+	struct DimOf {
+		using type = bench::Dim<int(I % 5) - 2, int(I / 5 % 5) - 2, int(I / 25 % 5) - 2, int(I / 125 % 5) - 2,
+		                        int(I / 625 % 5) - 2, int(I / 3 % 5) - 2, int(I / 7 % 5) - 2>;
+	};
+
+	template <std::size_t I>
+	struct Step {
+		using type = bench::DimDivide<bench::DimMultiply<typename DimOf<I>::type, typename DimOf<I + 1>::type>,
+		                              typename DimOf<I + 2>::type>;
+	};
+
+	// Blocks keep each fold short, so the time is spent on Dims rather than on the folds
+	constexpr std::size_t block = 64;
+
+	template <std::size_t Base, std::size_t... I>
+	constexpr int sum_block(std::index_sequence<I...>) {
+		return (0 + ... + (Step<Base + I>::type::d1 + Step<Base + I>::type::d4 + Step<Base + I>::type::d7));
+	}
+
+	template <std::size_t... J>
+	constexpr int sum_exponents(std::index_sequence<J...>) {
+		return (0 + ... + sum_block<J * block>(std::make_index_sequence<block>()));
+	}
+}
+
+constexpr int bench_dims = sum_exponents(std::make_index_sequence<64>());
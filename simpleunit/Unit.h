@@ -1,66 +1,221 @@
-#include <iostream>
+#ifndef SIMPLEUNIT_UNIT_H
+#define SIMPLEUNIT_UNIT_H
+
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <ratio>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(SUNIT_AUDIT_CONVERSIONS)
+#include "simpleunit/UnitAudit.h"
+
+// Count n conversions by R made at run time at site, in an audit build (see UnitAudit.h).
+// From and To are types or expressions of those types.
+#define SUNIT_AUDIT_CONVERSION(From, To, R, n, site) \
+	do { \
+		if constexpr (R::num != 1 || R::den != 1) { \
+			if (!__builtin_is_constant_evaluated()) \
+				::sunit::audit::record(typeid(From), typeid(To), R::num, R::den, site, n); \
+		} \
+	} while (0)
+
+// The casts and converting constructors take their call site as a trailing default argument
+// (SUNIT_AUDIT_SITE, or SUNIT_AUDIT_SITE_DECL where it is the only parameter), and pass it on
+// to the casts they make (SUNIT_AUDIT_PASS_SITE). The
+// arithmetic operators can't take one, so they are kept out of line and declare their return
+// address as the site (SUNIT_AUDIT_CALLER), and the operators forwarding to them are inlined.
+#define SUNIT_AUDIT_SITE_DECL ::sunit::audit::Site site = ::sunit::audit::Site::current()
+#define SUNIT_AUDIT_SITE , SUNIT_AUDIT_SITE_DECL
+#define SUNIT_AUDIT_PASS_SITE , site
+#define SUNIT_AUDIT_OPERATOR __attribute__((noinline))
+#define SUNIT_AUDIT_FORWARD __attribute__((always_inline))
+#define SUNIT_AUDIT_CALLER \
+	const ::sunit::audit::Site site = __builtin_is_constant_evaluated() ? ::sunit::audit::Site{} : \
+		::sunit::audit::Site::caller(__builtin_extract_return_addr(__builtin_return_address(0)))
+#else
+#define SUNIT_AUDIT_CONVERSION(From, To, R, n, site) do {} while (0)
+#define SUNIT_AUDIT_SITE_DECL
+#define SUNIT_AUDIT_SITE
+#define SUNIT_AUDIT_PASS_SITE
+#define SUNIT_AUDIT_OPERATOR
+#define SUNIT_AUDIT_FORWARD
+#define SUNIT_AUDIT_CALLER do {} while (0)
+#endif
 
 namespace sunit {
 
+// Reps that behave as floating-point without being built-in floating-point types, such as
+// the 16-bit storage types of UnitCompact.h, specialize this to convert by a single multiply,
+// as std::chrono::treat_as_floating_point is specialized for durations
+template <typename T>
+struct treat_as_floating_point : std::is_floating_point<T> {};
+
+// The type arithmetic on a rep is carried out in. Storage-only reps specialize this, so that
+// (like integral promotion of short) their sums and products are of a wider type.
+template <typename T>
+struct compute_type { using type = T; };
+
+template <typename T>
+using ComputeType = typename compute_type<T>::type;
+
 namespace
 {
 	template <typename X, typename Y>
-	using AddType = decltype(std::declval<X>() + std::declval<Y>());
+	using AddType = decltype(std::declval<ComputeType<X>>() + std::declval<ComputeType<Y>>());
 
 	template <typename X, typename Y>
-	using MulType = decltype(std::declval<X>() * std::declval<Y>());
+	using MulType = decltype(std::declval<ComputeType<X>>() * std::declval<ComputeType<Y>>());
 
 	template <typename D1, typename D2>
 	using DivType = decltype(std::declval<D1>() / std::declval<D2>());
 }
 
-template <int D1, int D2=0, int D3=0>
-struct Dim {
-	static constexpr int d1 = D1;
-	static constexpr int d2 = D2;
-	static constexpr int d3 = D3;
-};
+// Dimension exponents, in the order length, time, mass, current, temperature, amount and
+// luminous intensity, are packed four bits each (two's complement, -8..7) into a single
+// integer. A `Dim` is then a single template parameter however many dimensions it spans,
+// and multiplying or dividing Dims is a lane-wise (SWAR) add or subtract of their codes.
+
+using DimCode = std::uint32_t;
+
+constexpr int dim_count = 7;
+constexpr int dim_bits = 4;
+constexpr int dim_min = -(1 << (dim_bits - 1));
+constexpr int dim_max = (1 << (dim_bits - 1)) - 1;
+
+constexpr DimCode dim_high = 0x08888888;  // sign bit of each lane
+constexpr DimCode dim_low  = 0x07777777;  // all other bits of each lane
+
+constexpr int dim_exponent(DimCode code, std::size_t i) {
+	const int lane = static_cast<int>((code >> (i * dim_bits)) & 0xF);
+	return lane > dim_max ? lane - (1 << dim_bits) : lane;
+}
+
+constexpr DimCode dim_lane(int exponent, std::size_t i) {
+	return static_cast<DimCode>(exponent & 0xF) << (i * dim_bits);
+}
+
+// Lane-wise add and subtract, failing to compile if any exponent leaves [-8, 7]
+constexpr DimCode dim_add(DimCode a, DimCode b) {
+	const DimCode sum = ((a & dim_low) + (b & dim_low)) ^ ((a ^ b) & dim_high);
+	return (~(a ^ b) & (a ^ sum) & dim_high) ? throw std::overflow_error("sunit: dimension exponent out of range") : sum;
+}
 
-template <int A1, int A2, int A3, int B1, int B2, int B3>
-Dim<A1+B1, A2+B2, A3+B3> operator*(Dim<A1, A2, A3> lhs,
-	                               Dim<B1, B2, B3> rhs) {
-	return Dim<A1+B1, A2+B2, A3+B3>();
+constexpr DimCode dim_sub(DimCode a, DimCode b) {
+	const DimCode diff = ((a | dim_high) - (b & dim_low)) ^ ((a ^ ~b) & dim_high);
+	return ((a ^ b) & (a ^ diff) & dim_high) ? throw std::overflow_error("sunit: dimension exponent out of range") : diff;
 }
 
-template <int A1, int A2, int A3, int B1, int B2, int B3>
-using DimMultiply = Dim<A1+B1, A2+B2, A3+B3>;
+constexpr bool dim_in_range(int exponent) {
+	return exponent >= dim_min && exponent <= dim_max;
+}
+
+// Pack seven exponents, failing to compile if any lies outside [-8, 7]
+constexpr DimCode dim_encode(int d1, int d2, int d3, int d4, int d5, int d6, int d7) {
+	return dim_in_range(d1) && dim_in_range(d2) && dim_in_range(d3) && dim_in_range(d4) &&
+	       dim_in_range(d5) && dim_in_range(d6) && dim_in_range(d7)
+		? dim_lane(d1, 0) | dim_lane(d2, 1) | dim_lane(d3, 2) | dim_lane(d4, 3) |
+		  dim_lane(d5, 4) | dim_lane(d6, 5) | dim_lane(d7, 6)
+		: throw std::out_of_range("sunit: dimension exponents must lie in [-8, 7]");
+}
+
+// The exponents are written out, rather than calling dim_exponent, as they're evaluated for
+// every DimPack instantiated and function calls here measurably add to compile times.
+template <DimCode Code>
+struct DimPack {
+	static constexpr DimCode code = Code;
+	static constexpr int d1 = static_cast<int>((Code       & 0xF) ^ 0x8) - 0x8;
+	static constexpr int d2 = static_cast<int>((Code >>  4 & 0xF) ^ 0x8) - 0x8;
+	static constexpr int d3 = static_cast<int>((Code >>  8 & 0xF) ^ 0x8) - 0x8;
+	static constexpr int d4 = static_cast<int>((Code >> 12 & 0xF) ^ 0x8) - 0x8;
+	static constexpr int d5 = static_cast<int>((Code >> 16 & 0xF) ^ 0x8) - 0x8;
+	static constexpr int d6 = static_cast<int>((Code >> 20 & 0xF) ^ 0x8) - 0x8;
+	static constexpr int d7 = static_cast<int>((Code >> 24 & 0xF) ^ 0x8) - 0x8;
+};
+
+template <int D1, int D2=0, int D3=0, int D4=0, int D5=0, int D6=0, int D7=0>
+using Dim = DimPack<dim_encode(D1, D2, D3, D4, D5, D6, D7)>;
+
+template <DimCode A, DimCode B>
+constexpr DimPack<dim_add(A, B)> operator*(DimPack<A> lhs, DimPack<B> rhs) {
+	return DimPack<dim_add(A, B)>();
+}
 
-template <int A1, int l1, int A3, int B1, int B2, int B3>
-Dim<A1-B1, l1-B2, A3-B3> operator/(Dim<A1, l1, A3> lhs,
-	                               Dim<B1, B2, B3> rhs) {
-	return Dim<A1-B1, l1-B2, A3-B3>();
+template <DimCode A, DimCode B>
+constexpr DimPack<dim_sub(A, B)> operator/(DimPack<A> lhs, DimPack<B> rhs) {
+	return DimPack<dim_sub(A, B)>();
 }
 
-template <int A1, int A2, int A3>
-Dim<A1, A2, A3> operator+(Dim<A1, A2, A3> lhs,
-	                      Dim<A1, A2, A3> rhs) {
-	return Dim<A1, A2, A3>();
+template <DimCode A>
+constexpr DimPack<A> operator+(DimPack<A> lhs, DimPack<A> rhs) {
+	return DimPack<A>();
 }
 
-template <typename Dim = Dim<1>,
-          typename R1 = std::ratio<1>, typename R2 = std::ratio<1>, typename R3 = std::ratio<1>>
+// The dimensions of a product, quotient and sum, as direct aliases on the codes. These are
+// what the library uses: unlike the operators, they don't go through overload resolution.
+
+template <typename D1, typename D2>
+using DimMultiply = DimPack<dim_add(D1::code, D2::code)>;
+
+template <typename D1, typename D2>
+using DimDivide = DimPack<dim_sub(D1::code, D2::code)>;
+
+template <typename D1, typename D2>
+using DimAdd = std::enable_if_t<D1::code == D2::code, D1>;
+
+template <typename D = Dim<1>,
+          typename R1 = std::ratio<1>, typename R2 = std::ratio<1>, typename R3 = std::ratio<1>,
+          typename R4 = std::ratio<1>, typename R5 = std::ratio<1>, typename R6 = std::ratio<1>,
+          typename R7 = std::ratio<1>>
 struct BaseUnit
 {
-	using dim = Dim;
+	using dim = D;
 	using r1 = R1;
 	using r2 = R2;
 	using r3 = R3;
+	using r4 = R4;
+	using r5 = R5;
+	using r6 = R6;
+	using r7 = R7;
+	using ratios = std::tuple<R1, R2, R3, R4, R5, R6, R7>;
 };
 
+// The scale of the i'th dimension of base B
+template <typename B, std::size_t I>
+using RatioAt = std::tuple_element_t<I, typename B::ratios>;
+
+using DimIndices = std::make_index_sequence<dim_count>;
+
+template <typename R1, typename R2>
+constexpr bool ratio_is_multiple() {
+	return (R1::num * R2::den) % (R2::num * R1::den) == 0;
+}
+
+template <typename B1, typename B2, std::size_t... I>
+constexpr bool base_is_multiple(std::index_sequence<I...>) {
+	return (ratio_is_multiple<RatioAt<B1,I>, RatioAt<B2,I>>() && ...);
+}
 
 template <typename B1, typename B2>
-using IsMultiple = std::integral_constant<bool, (B1::r1::num * B2::r1::den) % (B2::r1::num * B1::r1::den) == 0 &&
-                                                (B1::r2::num * B2::r2::den) % (B2::r2::num * B1::r2::den) == 0 &&
-                                                (B1::r3::num * B2::r3::den) % (B2::r3::num * B1::r3::den) == 0 >;
+using IsMultiple = std::integral_constant<bool, base_is_multiple<B1,B2>(DimIndices())>;
+
+// The base of a std::chrono::duration<Rep, Period>, the same as Time<Period> below
+template <typename Period>
+using DurationBase = BaseUnit<Dim<0,1>, std::ratio<1>, Period>;
+
+template <typename B>
+using IsTimeBase = std::integral_constant<bool, B::dim::code == Dim<0,1>::code>;
+
+// The scale policy of units that don't name one, described with the others below
+struct FinestScale;
 
-template <typename T, typename B>
+// The policy of units that never rescale implicitly
+struct StrictScale;
+
+template <typename T, typename B, typename P>
 class Unit;
 
 constexpr int64_t ipow(int64_t base, int exp, int64_t result = 1) {
@@ -89,86 +244,307 @@ template <typename R1, typename R, int exp>
 using ConversionRatio = std::ratio_multiply<std::ratio<power_flip(R1::num, R1::den, exp), power_flip(R1::den, R1::num, exp)>,
                                             std::ratio<power_flip(R::den, R::num, exp), power_flip(R::num, R::den, exp)>>;
 
-template <typename ToUnit, typename X, typename B1, typename D = typename B1::dim>
-ToUnit dimension_cast(const Unit<X,B1>& unit)
+template <typename... R>
+struct RatioProduct { using type = std::ratio<1>; };
+
+template <typename R, typename... Rs>
+struct RatioProduct<R, Rs...> { using type = std::ratio_multiply<R, typename RatioProduct<Rs...>::type>; };
+
+template <typename B1, typename B, typename D, typename I = DimIndices>
+struct BaseConversionImpl;
+
+template <typename B1, typename B, typename D, std::size_t... I>
+struct BaseConversionImpl<B1, B, D, std::index_sequence<I...>> {
+	using type = typename RatioProduct<ConversionRatio<RatioAt<B1,I>, RatioAt<B,I>, dim_exponent(D::code, I)>...>::type;
+};
+
+// The single ratio converting a coefficient in base B1 to base B, for dimension D
+template <typename B1, typename B, typename D = typename B1::dim>
+using BaseConversion = typename BaseConversionImpl<B1, B, D>::type;
+
+// Whether a unit of base B1 and policy P1 may convert implicitly to base B under policy P:
+// always, unless either is strict and the conversion multiplies by anything but one
+template <typename B1, typename P1, typename B, typename P, typename R = BaseConversion<B1,B>>
+using IsImplicitConversion = std::integral_constant<bool,
+	(R::num == 1 && R::den == 1) || !(std::is_same<P1,StrictScale>::value || std::is_same<P,StrictScale>::value)>;
+
+// How a value of type Y is multiplied by a compile-time ratio, cheapest first.
+// The mul_div variants differ only in the intermediate needed to prove, at compile
+// time, that v * num cannot overflow for any v of type Y:
+//   mul_div:       computed in intmax_t, when max(Y) * num fits
+//   mul_div_split: (v / den) * num + (v % den) * num / den, when (den-1) * num fits in Y
+//   mul_div_wide:  computed in a 128-bit integer otherwise
+enum class RescaleKind { identity, scale, multiply, divide, mul_div, mul_div_split, mul_div_wide };
+
+constexpr bool product_fits(std::uintmax_t a, std::uintmax_t b, std::uintmax_t limit) {
+	return b == 0 || a <= limit / b;
+}
+
+template <typename Y, typename R>
+constexpr RescaleKind rescale_kind()
+{
+	using limits = std::numeric_limits<std::conditional_t<std::is_integral<Y>::value, Y, int>>;
+	if (R::num == 1 && R::den == 1)         return RescaleKind::identity;
+	if (treat_as_floating_point<Y>::value)  return RescaleKind::scale;
+	if (R::den == 1)                        return RescaleKind::multiply;
+	if (R::num == 1)                        return RescaleKind::divide;
+	if (product_fits(limits::max(), R::num, INTMAX_MAX))  return RescaleKind::mul_div;
+	if (product_fits(R::den - 1, R::num, limits::max()))  return RescaleKind::mul_div_split;
+	return RescaleKind::mul_div_wide;
+}
+
+template <typename Y, typename R, RescaleKind K = rescale_kind<Y,R>()>
+struct Rescale;
+
+template <typename Y, typename R>
+struct Rescale<Y, R, RescaleKind::identity> {
+	template <typename X>
+	static constexpr Y apply(const X& v) { return static_cast<Y>(v); }
+};
+
+// A single multiply by the ratio, folded to a constant at compile time. Compact reps are
+// multiplied in their compute type and rounded once.
+template <typename Y, typename R>
+struct Rescale<Y, R, RescaleKind::scale> {
+	using C = ComputeType<Y>;
+
+	static constexpr C factor() { return static_cast<C>(static_cast<long double>(R::num) / R::den); }
+
+	template <typename X>
+	static constexpr Y apply(const X& v) { return static_cast<Y>(static_cast<C>(v) * factor()); }
+};
+
+template <typename Y, typename R>
+struct Rescale<Y, R, RescaleKind::multiply> {
+	template <typename X>
+	static constexpr Y apply(const X& v) { return static_cast<Y>(v) * R::num; }
+};
+
+template <typename Y, typename R>
+struct Rescale<Y, R, RescaleKind::divide> {
+	template <typename X>
+	static constexpr Y apply(const X& v) { return static_cast<Y>(v) / R::den; }
+};
+
+template <typename Y, typename R>
+struct Rescale<Y, R, RescaleKind::mul_div> {
+	template <typename X>
+	static constexpr Y apply(const X& v) {
+		return static_cast<Y>(static_cast<std::intmax_t>(static_cast<Y>(v)) * R::num / R::den);
+	}
+};
+
+// Exact under C++ truncating division, since (v % den) has the sign of v
+template <typename Y, typename R>
+struct Rescale<Y, R, RescaleKind::mul_div_split> {
+	template <typename X>
+	static constexpr Y apply(const X& v) {
+		const Y y = static_cast<Y>(v);
+		return static_cast<Y>(y / R::den * R::num + y % R::den * R::num / R::den);
+	}
+};
+
+template <typename Y, typename R>
+struct Rescale<Y, R, RescaleKind::mul_div_wide> {
+#if defined(__SIZEOF_INT128__)
+	static_assert(static_cast<unsigned __int128>(std::numeric_limits<Y>::max()) * R::num <= (~static_cast<unsigned __int128>(0) >> 1),
+	              "Conversion ratio is too large for an exact integral conversion");
+
+	template <typename X>
+	static constexpr Y apply(const X& v) {
+		return static_cast<Y>(static_cast<__int128>(static_cast<Y>(v)) * R::num / R::den);
+	}
+#else
+	static_assert(R::num == 0, "Conversion ratio requires a 128-bit intermediate, which is unavailable");
+#endif
+};
+
+// Convert v to type Y and multiply by the ratio R
+template <typename Y, typename R, typename X>
+constexpr Y rescale(const X& v)
+{
+	return Rescale<Y,R>::apply(v);
+}
+
+// Overflow handling for integral conversions, selected by tag:
+//   unit_cast<ToUnit>(u, sunit::saturate)  clamps to the limits of the target rep
+//   unit_cast<ToUnit>(u, sunit::checked)   throws std::overflow_error
+struct saturate_t {};
+struct checked_t {};
+constexpr saturate_t saturate{};
+constexpr checked_t checked{};
+
+template <typename Y>
+constexpr Y on_overflow(bool negative, saturate_t) {
+	return negative ? std::numeric_limits<Y>::min() : std::numeric_limits<Y>::max();
+}
+
+template <typename Y>
+constexpr Y on_overflow(bool, checked_t) {
+	return throw std::overflow_error("sunit: integral unit conversion overflows"), Y();
+}
+
+template <typename Y, typename X, typename std::enable_if_t<std::is_integral<X>::value, int> = 0>
+constexpr bool in_range(const X& v) {
+	return v < 0 ? std::is_signed<Y>::value && static_cast<std::intmax_t>(v) >= static_cast<std::intmax_t>(std::numeric_limits<Y>::min())
+	             : static_cast<std::uintmax_t>(v) <= static_cast<std::uintmax_t>(std::numeric_limits<Y>::max());
+}
+
+template <typename Y, typename X, typename std::enable_if_t<treat_as_floating_point<X>::value, int> = 0>
+constexpr bool in_range(const X& v) {
+	// The upper bound is exclusive, as max(Y) + 1 is a power of two and so exactly representable
+	return static_cast<long double>(v) >= static_cast<long double>(std::numeric_limits<Y>::min()) &&
+	       static_cast<long double>(v) < static_cast<long double>(std::numeric_limits<Y>::max()) + 1;
+}
+
+template <typename Y, typename R, typename Policy, typename X>
+constexpr Y rescale(const X& v, Policy policy)
+{
+	static_assert(std::is_integral<Y>::value, "Saturating and checked conversions require an integral rep");
+
+	const bool negative = v < 0;
+	if (!in_range<Y>(v))
+		return on_overflow<Y>(negative, policy);
+
+	const Y y = static_cast<Y>(v);
+	Y result = 0;
+	switch (rescale_kind<Y,R>()) {
+	case RescaleKind::identity:
+	case RescaleKind::divide:
+		return rescale<Y,R>(y);
+	case RescaleKind::multiply:
+		if (__builtin_mul_overflow(y, R::num, &result))
+			return on_overflow<Y>(negative, policy);
+		return result;
+	default:
+		// The remainder term is bounded by num, so only the quotient term can overflow
+		if (__builtin_mul_overflow(y / R::den, R::num, &result) ||
+		    __builtin_add_overflow(result, rescale<Y,R>(static_cast<Y>(y % R::den)), &result))
+			return on_overflow<Y>(negative, policy);
+		return result;
+	}
+}
+
+template <typename ToUnit, typename X, typename B1, typename D = typename B1::dim, typename S>
+constexpr ToUnit dimension_cast(const Unit<X,B1,S>& unit SUNIT_AUDIT_SITE)
 {
 	using Y = typename ToUnit::rep;
 	using B = typename ToUnit::base;
+	using R = BaseConversion<B1,B,D>;
+
+	SUNIT_AUDIT_CONVERSION(unit, ToUnit, R, 1, site);
+	return ToUnit(rescale<Y,R>(unit.value()));
+}
 
-	using conversion = std::ratio_multiply<ConversionRatio<typename B1::r1, typename B::r1, D::d1>,
-	                   std::ratio_multiply<ConversionRatio<typename B1::r2, typename B::r2, D::d2>,
-	                                       ConversionRatio<typename B1::r3, typename B::r3, D::d3>>>;
+template <typename ToUnit, typename X, typename B1, typename D = typename B1::dim, typename S, typename Policy,
+          typename = std::enable_if_t<std::is_same<Policy,saturate_t>::value || std::is_same<Policy,checked_t>::value>>
+constexpr ToUnit dimension_cast(const Unit<X,B1,S>& unit, Policy policy SUNIT_AUDIT_SITE)
+{
+	using Y = typename ToUnit::rep;
+	using B = typename ToUnit::base;
+	using R = BaseConversion<B1,B,D>;
 
-	return ToUnit(static_cast<Y>(unit.value()) * conversion::num / conversion::den);
+	SUNIT_AUDIT_CONVERSION(unit, ToUnit, R, 1, site);
+	return ToUnit(rescale<Y,R>(unit.value(), policy));
 }
 
-template <typename ToUnit, typename X, typename B1>
-ToUnit unit_cast(const Unit<X,B1>& unit)
+template <typename ToUnit, typename X, typename B1, typename S>
+constexpr ToUnit unit_cast(const Unit<X,B1,S>& unit SUNIT_AUDIT_SITE)
 {
 	// todo: static_assert()
 	// A unit cast only casts between units of equal dimensions.
 	// To avoid this check, use dimension_cast.
 
 	using B = typename ToUnit::base;
-	return dimension_cast<ToUnit,X,B1,AddType<typename B1::dim,typename B::dim>>(unit);
+	return dimension_cast<ToUnit,X,B1,DimAdd<typename B1::dim,typename B::dim>>(unit SUNIT_AUDIT_PASS_SITE);
 }
 
-template <typename T, typename B = BaseUnit<>>
+template <typename ToUnit, typename X, typename B1, typename S, typename Policy,
+          typename = std::enable_if_t<std::is_same<Policy,saturate_t>::value || std::is_same<Policy,checked_t>::value>>
+constexpr ToUnit unit_cast(const Unit<X,B1,S>& unit, Policy policy SUNIT_AUDIT_SITE)
+{
+	using B = typename ToUnit::base;
+	return dimension_cast<ToUnit,X,B1,DimAdd<typename B1::dim,typename B::dim>>(unit, policy SUNIT_AUDIT_PASS_SITE);
+}
+
+template <typename T, typename B = BaseUnit<>, typename P = FinestScale>
 class Unit
 {
 public:
 	using rep = T;
 	using base = B;
+	using policy = P;
 
-	Unit(const T& val) : value_(val) {}
+	constexpr Unit(const T& val) : value_(val) {}
 
 	// The purpose of the following two construtors are to exclude the case for integral T but floating-point X
 	// and ensure no loss of information in the integral to integral constructor
 	// This convention is adpoted from std::chrono::duration
-	template < typename X, typename B1,
+	template < typename X, typename B1, typename P1,
 		typename std::enable_if_t<
 		    std::is_integral<T>::value &&
 		    std::is_integral<X>::value &&
-			IsMultiple<B1,B>::value, int > = 0 >
-	Unit(const Unit<X,B1>& rhs) {
-		value_ = unit_cast<Unit<T,B>>(rhs).value();
-	}
+			IsMultiple<B1,B>::value &&
+			IsImplicitConversion<B1,P1,B,P>::value, int > = 0 >
+	constexpr Unit(const Unit<X,B1,P1>& rhs SUNIT_AUDIT_SITE)
+		: value_(unit_cast<Unit>(rhs SUNIT_AUDIT_PASS_SITE).value()) {}
 
-	// The seemingly redundant test on `is_floating_point<X>` is required to make this
+	// The seemingly redundant test on `treat_as_floating_point<X>` is required to make this
 	// overload conditionally dependent on X (although there's probably a better way)
-	template < typename X, typename B1,
+	template < typename X, typename B1, typename P1,
 		typename std::enable_if_t<
-		    (std::is_floating_point<T>::value && std::is_floating_point<X>::value) ||
-		    (std::is_floating_point<T>::value && !std::is_floating_point<X>::value), int> = 0 >
-	Unit(const Unit<X,B1>& rhs) {
-		value_ = unit_cast<Unit<T,B>>(rhs).value();
+		    ((treat_as_floating_point<T>::value && treat_as_floating_point<X>::value) ||
+		    (treat_as_floating_point<T>::value && !treat_as_floating_point<X>::value)) &&
+			IsImplicitConversion<B1,P1,B,P>::value, int> = 0 >
+	constexpr Unit(const Unit<X,B1,P1>& rhs SUNIT_AUDIT_SITE)
+		: value_(unit_cast<Unit>(rhs SUNIT_AUDIT_PASS_SITE).value()) {}
+
+	// A conversion the above would make but for StrictScale. It's explicit, so the units still
+	// aren't convertible, and only here to explain why direct initialisation fails.
+	template < typename X, typename B1, typename P1,
+		typename std::enable_if_t<
+		    ((std::is_integral<T>::value && std::is_integral<X>::value && IsMultiple<B1,B>::value) ||
+		    treat_as_floating_point<T>::value) &&
+			!IsImplicitConversion<B1,P1,B,P>::value, int> = 0 >
+	constexpr explicit Unit(const Unit<X,B1,P1>&) : value_()
+	{
+		static_assert(IsImplicitConversion<B1,P1,B,P>::value,
+		              "sunit: StrictScale units don't convert between scales implicitly; use unit_cast");
 	}
 
-	T& value() { return value_; }
-	const T& value() const { return value_; }
+	// Units of time convert to and from std::chrono::duration implicitly, by the same rules.
+	// B1 defers the test on B until they are used.
+	template < typename X, typename Period, typename B1 = B,
+		typename std::enable_if_t<
+		    IsTimeBase<B1>::value &&
+		    std::is_convertible<Unit<X, DurationBase<Period>>, Unit>::value, int> = 0 >
+	constexpr Unit(const std::chrono::duration<X,Period>& d SUNIT_AUDIT_SITE)
+		: Unit(Unit<X, DurationBase<Period>>(d.count()) SUNIT_AUDIT_PASS_SITE) {}
 
-	template <typename Q = Unit<T,B>>
-	Q as() const { return unit_cast<Q>(*this); }
+	template < typename Rep, typename Period, typename B1 = B,
+		typename std::enable_if_t<
+		    IsTimeBase<B1>::value &&
+		    std::is_convertible<Unit, Unit<Rep, DurationBase<Period>>>::value, int> = 0 >
+	constexpr operator std::chrono::duration<Rep,Period>() const
+	{
+		return std::chrono::duration<Rep,Period>(Unit<Rep, DurationBase<Period>>(*this).value());
+	}
+
+	constexpr T& value() { return value_; }
+	constexpr const T& value() const { return value_; }
+
+	template <typename Q = Unit>
+	constexpr Q as(SUNIT_AUDIT_SITE_DECL) const { return unit_cast<Q>(*this SUNIT_AUDIT_PASS_SITE); }
 
-	template <typename Q = Unit<T,B>>
-	T asVal() const { return unit_cast<Q>(*this).value(); }
+	template <typename Q = Unit>
+	constexpr T asVal(SUNIT_AUDIT_SITE_DECL) const { return unit_cast<Q>(*this SUNIT_AUDIT_PASS_SITE).value(); }
 
-	Unit& operator+=(const Unit& rhs) { value_ += rhs.value(); return *this; }
-	Unit& operator-=(const Unit& rhs) { value_ -= rhs.value(); return *this; }
+	constexpr Unit& operator+=(const Unit& rhs) { value_ += rhs.value(); return *this; }
+	constexpr Unit& operator-=(const Unit& rhs) { value_ -= rhs.value(); return *this; }
 	template <typename X>
-	Unit& operator*=(const X& x) { value_ *= x; return *this; }
+	constexpr Unit& operator*=(const X& x) { value_ *= x; return *this; }
 	template <typename X>
-	Unit& operator/=(const X& x) { value_ /= x; return *this; }
-
-	friend std::ostream& operator<<(std::ostream& os, const Unit& q)
-	{
-		return os << q.value()
-		       << " (" << base::r1::num << "/" << base::r1::den
-		       << ", " << base::r2::num << "/" << base::r2::den
-		       << ", " << base::r3::num << "/" << base::r3::den
-		       << ")"
-		       << " [" << base::dim::d1 << "," << base::dim::d2 << "," << base::dim::d3 << "]";
-	}
+	constexpr Unit& operator/=(const X& x) { value_ /= x; return *this; }
 
 private:
 	T value_;
@@ -177,48 +553,164 @@ private:
 template <typename R1, typename R2>
 using CommonRatio = typename std::common_type<std::chrono::duration<int,R1>, std::chrono::duration<int,R2>>::type::period;
 
+template <typename D, typename B1, typename B2, typename I = DimIndices>
+struct CommonBaseImpl;
+
+template <typename D, typename B1, typename B2, std::size_t... I>
+struct CommonBaseImpl<D, B1, B2, std::index_sequence<I...>> {
+	using type = BaseUnit<D, CommonRatio<RatioAt<B1,I>, RatioAt<B2,I>>...>;
+};
+
 template <typename D, typename B1, typename B2>
-using CommonBase = BaseUnit<D, CommonRatio<typename B1::r1 , typename B2::r1>,
-                               CommonRatio<typename B1::r2 , typename B2::r2>,
-                               CommonRatio<typename B1::r3 , typename B2::r3>>;
+using CommonBase = typename CommonBaseImpl<D, B1, B2>::type;
+
+// Scale policies
+//
+// Where the operands of + - * / have different scales, the policy of the result picks its
+// scale. `FinestScale`, the default, takes the finest common ratio in each dimension, so
+// integral values convert without loss, though both operands may need rescaling. Other
+// policies save conversions for floating-point reps. `LeftScale` keeps the scale of the
+// left operand so only the right one is converted, `RightScale` that of the right, and
+// `SIScale` converts both to unit ratios. In products, a dimension only one operand has
+// keeps that operand's scale. Operands of different policies take the one that isn't
+// `FinestScale`, and two other policies don't mix.
+//
+// `StrictScale` rescales nothing implicitly, for code that must be free of conversions.
+// Operands must have the same scale in each dimension they share, and a strict unit only
+// converts implicitly to or from a unit of the same scales; anything else is a compile error
+// unless asked for with unit_cast. `Strict<U>` makes a unit strict, and `si::strict` has the
+// strict units of `si`.
+//
+//     using FastInches = Unit<float, Length<inch>, LeftScale>;
+//     auto x = FastInches(1) + Centimeters(5);     // in inches, with one multiply
+
+template <typename B1, typename B2, std::size_t I>
+using PreferredRatio = std::conditional_t<dim_exponent(B1::dim::code, I) != 0, RatioAt<B1,I>,
+	std::conditional_t<dim_exponent(B2::dim::code, I) != 0, RatioAt<B2,I>, std::ratio<1>>>;
+
+template <typename D, typename B1, typename B2, typename I = DimIndices>
+struct PreferredBaseImpl;
+
+template <typename D, typename B1, typename B2, std::size_t... I>
+struct PreferredBaseImpl<D, B1, B2, std::index_sequence<I...>> {
+	using type = BaseUnit<D, PreferredRatio<B1,B2,I>...>;
+};
+
+// The ratios of B1 where it has the dimension, and otherwise those of B2
+template <typename D, typename B1, typename B2>
+using PreferredBase = typename PreferredBaseImpl<D, B1, B2>::type;
+
+struct FinestScale {
+	template <typename D, typename B1, typename B2>
+	using base = CommonBase<D, B1, B2>;
+};
+
+struct LeftScale {
+	template <typename D, typename B1, typename B2>
+	using base = PreferredBase<D, B1, B2>;
+};
+
+struct RightScale {
+	template <typename D, typename B1, typename B2>
+	using base = PreferredBase<D, B2, B1>;
+};
+
+struct SIScale {
+	template <typename D, typename B1, typename B2>
+	using base = BaseUnit<D>;
+};
+
+template <typename B1, typename B2, std::size_t I>
+constexpr bool same_scale_at() {
+	return dim_exponent(B1::dim::code, I) == 0 || dim_exponent(B2::dim::code, I) == 0 ||
+	       std::ratio_equal<RatioAt<B1,I>, RatioAt<B2,I>>::value;
+}
+
+template <typename D, typename B1, typename B2, typename I = DimIndices>
+struct StrictBaseImpl;
+
+template <typename D, typename B1, typename B2, std::size_t... I>
+struct StrictBaseImpl<D, B1, B2, std::index_sequence<I...>> {
+	static_assert((same_scale_at<B1,B2,I>() && ...),
+	              "sunit: StrictScale operands differ in scale, so one would be rescaled; unit_cast it first");
+	using type = PreferredBase<D, B1, B2>;
+};
+
+struct StrictScale {
+	template <typename D, typename B1, typename B2>
+	using base = typename StrictBaseImpl<D, B1, B2>::type;
+};
+
+template <typename P1, typename P2>
+struct CommonPolicyImpl {
+	static_assert(std::is_same<P1,P2>::value, "Operands have different scale policies");
+	using type = P1;
+};
+
+template <typename P>
+struct CommonPolicyImpl<FinestScale, P> { using type = P; };
+
+template <typename P>
+struct CommonPolicyImpl<P, FinestScale> { using type = P; };
+
+template <>
+struct CommonPolicyImpl<FinestScale, FinestScale> { using type = FinestScale; };
+
+template <typename P1, typename P2>
+using CommonPolicy = typename CommonPolicyImpl<P1,P2>::type;
+
+// The base of a result of dimensions D under policy P
+template <typename P, typename D, typename B1, typename B2>
+using PolicyBase = typename P::template base<D, B1, B2>;
+
+// Unit with the same rep and base as U, under policy P
+template <typename U, typename P>
+using WithPolicy = Unit<typename U::rep, typename U::base, P>;
+
+template <typename U>
+using Strict = WithPolicy<U, StrictScale>;
 
 // Unit + - * / Unit
 
-template <typename X, typename Y, typename B1, typename B2,
-          typename ToUnit = Unit< AddType<X,Y>, CommonBase<AddType<typename B1::dim,typename B2::dim>,B1,B2>> >
-ToUnit operator+(const Unit<X,B1>& lhs, const Unit<Y,B2>& rhs)
+template <typename X, typename Y, typename B1, typename B2, typename P1, typename P2, typename P = CommonPolicy<P1,P2>,
+          typename ToUnit = Unit< AddType<X,Y>, PolicyBase<P, DimAdd<typename B1::dim,typename B2::dim>,B1,B2>, P> >
+SUNIT_AUDIT_OPERATOR constexpr ToUnit operator+(const Unit<X,B1,P1>& lhs, const Unit<Y,B2,P2>& rhs)
 {
 	using B = typename ToUnit::base;
-	return ToUnit(unit_cast<Unit<X,B>>(lhs).value() + unit_cast<Unit<Y,B>>(rhs).value());
+	SUNIT_AUDIT_CALLER;
+	return ToUnit(unit_cast<Unit<ComputeType<X>,B>>(lhs SUNIT_AUDIT_PASS_SITE).value() + unit_cast<Unit<ComputeType<Y>,B>>(rhs SUNIT_AUDIT_PASS_SITE).value());
 }
 
-template <typename X, typename Y, typename B1, typename B2,
-          typename ToUnit = Unit< AddType<X,Y>, CommonBase<AddType<typename B1::dim,typename B2::dim>,B1,B2>> >
-ToUnit operator-(const Unit<X,B1>& lhs, const Unit<Y,B2>& rhs)
+template <typename X, typename Y, typename B1, typename B2, typename P1, typename P2, typename P = CommonPolicy<P1,P2>,
+          typename ToUnit = Unit< AddType<X,Y>, PolicyBase<P, DimAdd<typename B1::dim,typename B2::dim>,B1,B2>, P> >
+SUNIT_AUDIT_OPERATOR constexpr ToUnit operator-(const Unit<X,B1,P1>& lhs, const Unit<Y,B2,P2>& rhs)
 {
 	using B = typename ToUnit::base;
-	return ToUnit(unit_cast<Unit<X,B>>(lhs).value() - unit_cast<Unit<Y,B>>(rhs).value());
+	SUNIT_AUDIT_CALLER;
+	return ToUnit(unit_cast<Unit<ComputeType<X>,B>>(lhs SUNIT_AUDIT_PASS_SITE).value() - unit_cast<Unit<ComputeType<Y>,B>>(rhs SUNIT_AUDIT_PASS_SITE).value());
 }
 
-template <typename X, typename Y, typename B1, typename B2,
-          typename ToUnit = Unit< AddType<X,Y>, CommonBase<MulType<typename B1::dim,typename B2::dim>,B1,B2>> >
-ToUnit operator*(const Unit<X,B1>& lhs, const Unit<Y,B2>& rhs)
+template <typename X, typename Y, typename B1, typename B2, typename P1, typename P2, typename P = CommonPolicy<P1,P2>,
+          typename ToUnit = Unit< AddType<X,Y>, PolicyBase<P, DimMultiply<typename B1::dim,typename B2::dim>,B1,B2>, P> >
+SUNIT_AUDIT_OPERATOR constexpr ToUnit operator*(const Unit<X,B1,P1>& lhs, const Unit<Y,B2,P2>& rhs)
 {
 	using B = typename ToUnit::base;
-	return ToUnit(dimension_cast<Unit<X,B>>(lhs).value() * dimension_cast<Unit<Y,B>>(rhs).value());
+	SUNIT_AUDIT_CALLER;
+	return ToUnit(dimension_cast<Unit<ComputeType<X>,B>>(lhs SUNIT_AUDIT_PASS_SITE).value() * dimension_cast<Unit<ComputeType<Y>,B>>(rhs SUNIT_AUDIT_PASS_SITE).value());
 }
 
-template <typename X, typename Y, typename B1, typename B2,
-          typename ToUnit = Unit< AddType<X,Y>, CommonBase<DivType<typename B1::dim,typename B2::dim>,B1,B2>> >
-ToUnit operator/(const Unit<X,B1>& lhs, const Unit<Y,B2>& rhs)
+template <typename X, typename Y, typename B1, typename B2, typename P1, typename P2, typename P = CommonPolicy<P1,P2>,
+          typename ToUnit = Unit< AddType<X,Y>, PolicyBase<P, DimDivide<typename B1::dim,typename B2::dim>,B1,B2>, P> >
+SUNIT_AUDIT_OPERATOR constexpr ToUnit operator/(const Unit<X,B1,P1>& lhs, const Unit<Y,B2,P2>& rhs)
 {
 	using B = typename ToUnit::base;
-	return ToUnit(dimension_cast<Unit<X,B>>(lhs).value() / dimension_cast<Unit<Y,B>>(rhs).value());
+	SUNIT_AUDIT_CALLER;
+	return ToUnit(dimension_cast<Unit<ComputeType<X>,B>>(lhs SUNIT_AUDIT_PASS_SITE).value() / dimension_cast<Unit<ComputeType<Y>,B>>(rhs SUNIT_AUDIT_PASS_SITE).value());
 }
 
 // Todo: see `TEST(UnitTest, DivType)`
-template <typename X, typename Y, typename B>
-MulType<X,Y> operator/(const Unit<X,B>& lhs, const Unit<Y,B>& rhs)
+template <typename X, typename Y, typename B, typename P1, typename P2>
+constexpr MulType<X,Y> operator/(const Unit<X,B,P1>& lhs, const Unit<Y,B,P2>& rhs)
 {
 	return MulType<X,Y>(lhs.value() / rhs.value());
 }
@@ -226,25 +718,182 @@ MulType<X,Y> operator/(const Unit<X,B>& lhs, const Unit<Y,B>& rhs)
 
 // Scalar * * / Unit
 
-template <typename X, typename Y, typename B,
+template <typename X, typename Y, typename B, typename P,
           typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
-Unit<MulType<X,Y>,B> operator*(const Unit<X,B>& lhs, const Y& y)
+constexpr Unit<MulType<X,Y>,B,P> operator*(const Unit<X,B,P>& lhs, const Y& y)
 {
-	return Unit<MulType<X,Y>,B>(lhs.value() * y);
+	return Unit<MulType<X,Y>,B,P>(lhs.value() * y);
 }
 
-template <typename X, typename Y, typename B,
+template <typename X, typename Y, typename B, typename P,
           typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
-Unit<MulType<X,Y>,B> operator*(const Y& y, const Unit<X,B>& rhs)
+constexpr Unit<MulType<X,Y>,B,P> operator*(const Y& y, const Unit<X,B,P>& rhs)
 {
-	return Unit<MulType<X,Y>,B>(rhs.value() * y);
+	return Unit<MulType<X,Y>,B,P>(rhs.value() * y);
 }
 
-template <typename X, typename Y, typename B,
+template <typename X, typename Y, typename B, typename P,
           typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
-Unit<MulType<X,Y>,B> operator/(const Unit<X,B>& lhs, const Y& y)
+constexpr Unit<MulType<X,Y>,B,P> operator/(const Unit<X,B,P>& lhs, const Y& y)
+{
+	return Unit<MulType<X,Y>,B,P>(lhs.value() / y);
+}
+
+
+// std::chrono::duration
+//
+// A Unit of time converts implicitly to and from a duration where no information is lost,
+// as between Units, and compiles to nothing where their ratios match. Other conversions are
+// explicit, by unit_cast and duration_cast. In arithmetic with Units, a duration<Rep, Period>
+// is a Unit<Rep, Time<Period>>, so `m_s(3) * std::chrono::milliseconds(500)` is a length
+// at the common scale of the two.
+
+template <typename Rep, typename Period>
+using DurationUnit = Unit<Rep, DurationBase<Period>>;
+
+// The Unit of time with the rep and scale of d
+template <typename Rep, typename Period>
+constexpr DurationUnit<Rep,Period> to_unit(const std::chrono::duration<Rep,Period>& d)
 {
-	return Unit<MulType<X,Y>,B>(lhs.value() / y);
+	return DurationUnit<Rep,Period>(d.count());
+}
+
+template <typename ToUnit, typename Rep, typename Period>
+constexpr ToUnit unit_cast(const std::chrono::duration<Rep,Period>& d SUNIT_AUDIT_SITE)
+{
+	return unit_cast<ToUnit>(to_unit(d) SUNIT_AUDIT_PASS_SITE);
+}
+
+// Converted in the common type of the reps, as std::chrono::duration_cast converts
+template <typename ToDuration, typename X, typename B, typename P>
+constexpr ToDuration duration_cast(const Unit<X,B,P>& unit SUNIT_AUDIT_SITE)
+{
+	static_assert(IsTimeBase<B>::value, "Only units of time convert to a std::chrono::duration");
+	using Rep = typename ToDuration::rep;
+	using C = std::common_type_t<ComputeType<X>, Rep>;
+	return ToDuration(static_cast<Rep>(unit_cast<DurationUnit<C, typename ToDuration::period>>(unit SUNIT_AUDIT_PASS_SITE).value()));
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator+(const Unit<X,B,P>& lhs, const std::chrono::duration<Rep,Period>& rhs) -> decltype(lhs + to_unit(rhs))
+{
+	return lhs + to_unit(rhs);
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator+(const std::chrono::duration<Rep,Period>& lhs, const Unit<X,B,P>& rhs) -> decltype(to_unit(lhs) + rhs)
+{
+	return to_unit(lhs) + rhs;
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator-(const Unit<X,B,P>& lhs, const std::chrono::duration<Rep,Period>& rhs) -> decltype(lhs - to_unit(rhs))
+{
+	return lhs - to_unit(rhs);
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator-(const std::chrono::duration<Rep,Period>& lhs, const Unit<X,B,P>& rhs) -> decltype(to_unit(lhs) - rhs)
+{
+	return to_unit(lhs) - rhs;
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator*(const Unit<X,B,P>& lhs, const std::chrono::duration<Rep,Period>& rhs) -> decltype(lhs * to_unit(rhs))
+{
+	return lhs * to_unit(rhs);
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator*(const std::chrono::duration<Rep,Period>& lhs, const Unit<X,B,P>& rhs) -> decltype(to_unit(lhs) * rhs)
+{
+	return to_unit(lhs) * rhs;
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator/(const Unit<X,B,P>& lhs, const std::chrono::duration<Rep,Period>& rhs) -> decltype(lhs / to_unit(rhs))
+{
+	return lhs / to_unit(rhs);
+}
+
+template <typename X, typename B, typename P, typename Rep, typename Period>
+SUNIT_AUDIT_FORWARD constexpr auto operator/(const std::chrono::duration<Rep,Period>& lhs, const Unit<X,B,P>& rhs) -> decltype(to_unit(lhs) / rhs)
+{
+	return to_unit(lhs) / rhs;
+}
+
+
+// Scalar division at a finer scale
+//
+// Dividing by a scalar defers to T, so for integral reps 1 m / 2 == 0 m. Dividing with
+// `refine<R>` instead gives the quotient in a unit R times as large, so that
+// divide(1 m, 2, refine<std::centi>) == 50 cm. Dividing by `divisor<N>` refines by the
+// smallest power of ten that N divides, so 1 m / divisor<2> == 5 dm, exactly. The refined
+// dimension is the first with an exponent of 1 or -1. The value is scaled up before it's
+// divided, so an integral rep needs the room for it.
+
+constexpr std::size_t refined_lane(DimCode code) {
+	for (std::size_t i = 0; i < dim_count; ++i)
+		if (dim_exponent(code, i) == 1 || dim_exponent(code, i) == -1)
+			return i;
+	return dim_count;
+}
+
+template <typename B, typename R, typename I = DimIndices>
+struct RefinedBaseImpl;
+
+template <typename B, typename R, std::size_t... I>
+struct RefinedBaseImpl<B, R, std::index_sequence<I...>> {
+	static constexpr std::size_t lane = refined_lane(B::dim::code);
+	static_assert(lane < dim_count, "Refining a unit needs a dimension with an exponent of 1 or -1");
+
+	// A unit in the refined dimension R times as large: r * R, or r / R under division
+	using ratio = std::conditional_t<(dim_exponent(B::dim::code, lane) > 0),
+		std::ratio_multiply<RatioAt<B,lane>, R>, std::ratio_divide<RatioAt<B,lane>, R>>;
+	using type = BaseUnit<typename B::dim, std::conditional_t<I == lane, ratio, RatioAt<B,I>>...>;
+};
+
+template <typename B, typename R>
+using RefinedBase = typename RefinedBaseImpl<B,R>::type;
+
+template <typename R>
+struct refine_t {
+	static_assert(R::num == 1 && R::den > 1, "Refine by a ratio of 1/n, such as std::milli");
+};
+
+template <typename R>
+constexpr refine_t<R> refine{};
+
+template <std::intmax_t N>
+struct divisor_t {
+	static_assert(N > 1, "Divide by a divisor greater than 1");
+};
+
+template <std::intmax_t N>
+constexpr divisor_t<N> divisor{};
+
+// The smallest power of ten that n divides, or n itself if there is none
+constexpr std::intmax_t decimal_refinement(std::intmax_t n) {
+	for (std::intmax_t p = 10; ; p *= 10) {
+		if (p % n == 0)
+			return p;
+		if (p > INTMAX_MAX / 10)
+			return n;
+	}
+}
+
+template <typename X, typename Y, typename B, typename P, typename R,
+          typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
+constexpr Unit<MulType<X,Y>, RefinedBase<B,R>, P> divide(const Unit<X,B,P>& lhs, const Y& y, refine_t<R>)
+{
+	using T = MulType<X,Y>;
+	return Unit<T, RefinedBase<B,R>, P>(static_cast<T>(lhs.value() * static_cast<T>(R::den) / y));
+}
+
+template <typename X, typename B, typename P, std::intmax_t N>
+constexpr auto operator/(const Unit<X,B,P>& lhs, divisor_t<N>)
+{
+	return divide(lhs, static_cast<X>(N), refine<std::ratio<1, decimal_refinement(N)>>);
 }
 
 
@@ -256,10 +905,15 @@ template <int n, int d> using BaseRatio = BaseUnit<Dim<1>, std::ratio<n,d>>;
 
 template <typename r> using Length  = BaseUnit<Dim<1>, r>;
 template <typename r> using Length2 = BaseUnit<Dim<2>, r>;
-template <typename r> using Length3 = BaseUnit<Dim<2>, r>;
-template <typename r> using Time    = BaseUnit<Dim<0,1>, r>;
-template <typename r> using Time2   = BaseUnit<Dim<0,2>, r>;
-template <typename r> using Mass    = BaseUnit<Dim<0,0,1>, r>;
+template <typename r> using Length3 = BaseUnit<Dim<3>, r>;
+template <typename r> using Time    = BaseUnit<Dim<0,1>, std::ratio<1>, r>;
+template <typename r> using Time2   = BaseUnit<Dim<0,2>, std::ratio<1>, r>;
+template <typename r> using Mass    = BaseUnit<Dim<0,0,1>, std::ratio<1>, std::ratio<1>, r>;
+
+template <typename r> using Current     = BaseUnit<Dim<0,0,0,1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, r>;
+template <typename r> using Temperature = BaseUnit<Dim<0,0,0,0,1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, r>;
+template <typename r> using Amount      = BaseUnit<Dim<0,0,0,0,0,1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, r>;
+template <typename r> using Luminosity  = BaseUnit<Dim<0,0,0,0,0,0,1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, std::ratio<1>, r>;
 
 // Derived dimensions
 
@@ -267,7 +921,8 @@ template <typename r1, typename r2> using Velocity       = BaseUnit<Dim<1,-1>, r
 template <typename r1, typename r2> using Acceleration   = BaseUnit<Dim<1,-2>, r1, r2>;
 template <typename r1, typename r2> using VolumetricFlux = BaseUnit<Dim<2,-1>, r1, r2>;
 
-template <typename r1, typename r2, typename r3> using Force = BaseUnit<Dim<1,1,-2>, r1, r2, r3>;
+template <typename r1, typename r2, typename r3> using Force    = BaseUnit<Dim<1,-2,1>, r1, r2, r3>;
+template <typename r1, typename r2, typename r3> using Pressure = BaseUnit<Dim<-1,-2,1>, r1, r2, r3>;
 
 
 namespace si {
@@ -277,6 +932,10 @@ namespace si {
 	using meter = std::ratio<1>;
 	using second = std::ratio<1>;
 	using kg = std::ratio<1>;
+	using ampere = std::ratio<1>;
+	using kelvin = std::ratio<1>;
+	using mole = std::ratio<1>;
+	using candela = std::ratio<1>;
 
 	using inch = std::ratio<1,39>;
 	using minute = std::ratio<60>;
@@ -302,6 +961,12 @@ namespace si {
 
 	using Kilograms = Unit<float, Mass<kg>>;
 
+	using Amperes = Unit<float, Current<ampere>>;
+	using Milliamperes = Unit<float, Current<std::milli>>;
+	using Kelvin = Unit<float, Temperature<kelvin>>;
+	using Moles = Unit<float, Amount<mole>>;
+	using Candelas = Unit<float, Luminosity<candela>>;
+
 	// Units (short?)
 
 	using m = Unit<float, Length<meter>>;
@@ -323,37 +988,115 @@ namespace si {
 	using in_hr = Unit<float, Velocity<inch, hour>>;
 	using kgm_s2 = Unit<float, Force<meter, second, kg>>;
 
+	using Pascals = Unit<float, Pressure<meter, second, kg>>;
+
 	// Constants
 
-	// Todo: Unit a literal type
-	//constexpr m_s2 g(9.81);
+	constexpr m_s2 g(9.80665f);         // standard gravity
+	constexpr m_s c(299792458.f);       // speed of light in vacuum
+	constexpr Pascals atm(101325.f);    // standard atmosphere
+
+	// Strict units, which don't rescale implicitly
+
+	namespace strict {
+
+		using Meters = Strict<si::Meters>;
+		using Meters2 = Strict<si::Meters2>;
+		using Meters3 = Strict<si::Meters3>;
+		using Centimeters = Strict<si::Centimeters>;
+		using Centimeters2 = Strict<si::Centimeters2>;
+		using Centimeters3 = Strict<si::Centimeters3>;
+		using Millimeters = Strict<si::Millimeters>;
+		using Millimeters2 = Strict<si::Millimeters2>;
+		using Millimeters3 = Strict<si::Millimeters3>;
+		using Inches = Strict<si::Inches>;
+
+		using Seconds = Strict<si::Seconds>;
+		using Minutes = Strict<si::Minutes>;
+		using Hours = Strict<si::Hours>;
+
+		using Kilograms = Strict<si::Kilograms>;
+		using Amperes = Strict<si::Amperes>;
+		using Milliamperes = Strict<si::Milliamperes>;
+		using Kelvin = Strict<si::Kelvin>;
+		using Moles = Strict<si::Moles>;
+		using Candelas = Strict<si::Candelas>;
+
+		using m = Strict<si::m>;
+		using in = Strict<si::in>;
+
+		using Meters_Second = Strict<si::Meters_Second>;
+		using Meters_Second2 = Strict<si::Meters_Second2>;
+		using Inches_Hour = Strict<si::Inches_Hour>;
+		using KilogramMeters_Second2 = Strict<si::KilogramMeters_Second2>;
+		using Meters2_Second = Strict<si::Meters2_Second>;
+		using Inches2_Second = Strict<si::Inches2_Second>;
+
+		using m_s = Strict<si::m_s>;
+		using m_s2 = Strict<si::m_s2>;
+		using in_hr = Strict<si::in_hr>;
+		using kgm_s2 = Strict<si::kgm_s2>;
+
+		using Pascals = Strict<si::Pascals>;
+
+	} // strict
 
 } // si
 
 
-// Examples, to fill out
+// Literals for each unit in `si`, as constants: integer literals give int64_t values and
+// floating-point literals give doubles, like std::chrono's literals
+//
+//     using namespace sunit::literals;
+//     constexpr si::Meters depths[] = { 5_m, 200_cm, 1.5_m };
 
-std::ostream& operator<<(std::ostream& os, const si::Meters& q)
-{ return os << q.value() << " m"; }
-std::ostream& operator<<(std::ostream& os, const si::Centimeters& q)
-{ return os << q.value() << " cm"; }
-std::ostream& operator<<(std::ostream& os, const si::Millimeters& q)
-{ return os << q.value() << " mm"; }
+namespace literals {
 
-std::ostream& operator<<(std::ostream& os, const si::Meters2_Second& q)
-{ return os << q.value() << " m^2/s"; }
-std::ostream& operator<<(std::ostream& os, const si::Inches2_Second& q)
-{ return os << q.value() << " in^2/s"; }
+#define SUNIT_LITERAL(suffix, U) \
+	constexpr Unit<std::int64_t, U::base> operator""_##suffix(unsigned long long v) \
+	{ return Unit<std::int64_t, U::base>(static_cast<std::int64_t>(v)); } \
+	constexpr Unit<double, U::base> operator""_##suffix(long double v) \
+	{ return Unit<double, U::base>(static_cast<double>(v)); }
 
-std::ostream& operator<<(std::ostream& os, const si::Meters2& q)
-{ return os << q.value() << " m^2"; }
-std::ostream& operator<<(std::ostream& os, const si::Centimeters2& q)
-{ return os << q.value() << " cm^2"; }
+	SUNIT_LITERAL(m, si::Meters)
+	SUNIT_LITERAL(m2, si::Meters2)
+	SUNIT_LITERAL(m3, si::Meters3)
+	SUNIT_LITERAL(cm, si::Centimeters)
+	SUNIT_LITERAL(cm2, si::Centimeters2)
+	SUNIT_LITERAL(cm3, si::Centimeters3)
+	SUNIT_LITERAL(mm, si::Millimeters)
+	SUNIT_LITERAL(mm2, si::Millimeters2)
+	SUNIT_LITERAL(mm3, si::Millimeters3)
+	SUNIT_LITERAL(in, si::Inches)
 
-std::ostream& operator<<(std::ostream& os, const si::m_s& q)
-{ return os << q.value() << " m/s"; }
+	SUNIT_LITERAL(s, si::Seconds)
+	SUNIT_LITERAL(min, si::Minutes)
+	SUNIT_LITERAL(h, si::Hours)
 
-std::ostream& operator<<(std::ostream& os, const si::in_hr& q)
-{ return os << q.value() << " in/hr"; }
+	SUNIT_LITERAL(kg, si::Kilograms)
+
+	SUNIT_LITERAL(A, si::Amperes)
+	SUNIT_LITERAL(mA, si::Milliamperes)
+	SUNIT_LITERAL(K, si::Kelvin)
+	SUNIT_LITERAL(mol, si::Moles)
+	SUNIT_LITERAL(cd, si::Candelas)
+
+	SUNIT_LITERAL(m_s, si::Meters_Second)
+	SUNIT_LITERAL(m_s2, si::Meters_Second2)
+	SUNIT_LITERAL(in_hr, si::Inches_Hour)
+	SUNIT_LITERAL(kgm_s2, si::KilogramMeters_Second2)
+	SUNIT_LITERAL(m2_s, si::Meters2_Second)
+	SUNIT_LITERAL(in2_s, si::Inches2_Second)
+	SUNIT_LITERAL(Pa, si::Pascals)
+
+#undef SUNIT_LITERAL
+
+} // literals
 
 } // sunit
+
+// operator<< for every Unit lives with the rest of the formatting, and is
+// included here so code that includes only this header can still stream units
+#include "simpleunit/UnitFormat.h"
+
+#endif // SIMPLEUNIT_UNIT_H
@@ -0,0 +1,370 @@
+#ifndef SIMPLEUNIT_UNITALGORITHM_H
+#define SIMPLEUNIT_UNITALGORITHM_H
+
+#include "simpleunit/UnitArray.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sunit {
+
+// Reductions over spans of units.
+//
+// Results carry the dimension of the operation: the sum of Meters is Meters, and the dot
+// product of a velocity and a time span is a length, at the scale the Unit operators give.
+// Sums are compensated by default. Passing `par()` first runs them across threads: the span
+// is cut into fixed chunks which threads claim dynamically, and partial results are combined
+// in chunk order, so the result doesn't depend on the number of threads. The calling thread
+// works on chunks too, helped by threads of a pool that is started on first use and kept
+// for later calls. An exception thrown by an operation stops the reduction, and is rethrown
+// on the calling thread.
+
+enum class Summation {
+	naive,     // sum += x
+	kahan,     // Kahan compensated summation
+	pairwise   // recursive pairwise summation
+};
+
+struct Parallel {
+	unsigned threads;          // 0 for the hardware concurrency
+	std::size_t grain;         // elements per chunk
+};
+
+inline Parallel par(unsigned threads = 0, std::size_t grain = std::size_t(1) << 16)
+{
+	return Parallel{ threads, grain };
+}
+
+namespace detail
+{
+	template <typename T>
+	class KahanSum
+	{
+	public:
+		void add(const T& x) {
+			const T y = x - c_;
+			const T t = sum_ + y;
+			c_ = (t - sum_) - y;
+			sum_ = t;
+		}
+		T result() const { return sum_; }
+
+	private:
+		T sum_ = T(0);
+		T c_ = T(0);
+	};
+
+	template <typename T>
+	class NaiveSum
+	{
+	public:
+		void add(const T& x) { sum_ += x; }
+		T result() const { return sum_; }
+
+	private:
+		T sum_ = T(0);
+	};
+
+	// Sum f(i) for i in [first, last)
+	template <typename T, typename F>
+	T pairwise_sum(std::size_t first, std::size_t last, const F& f)
+	{
+		constexpr std::size_t block = 128;
+		if (last - first <= block) {
+			T sum = T(0);
+			for (std::size_t i = first; i < last; ++i)
+				sum += f(i);
+			return sum;
+		}
+		const std::size_t mid = first + (last - first) / 2;
+		return pairwise_sum<T>(first, mid, f) + pairwise_sum<T>(mid, last, f);
+	}
+
+	template <typename T, typename F>
+	T sum_range(std::size_t first, std::size_t last, const F& f, Summation summation)
+	{
+		switch (summation) {
+		case Summation::pairwise:
+			return pairwise_sum<T>(first, last, f);
+		case Summation::kahan: {
+			KahanSum<T> sum;
+			for (std::size_t i = first; i < last; ++i)
+				sum.add(f(i));
+			return sum.result();
+		}
+		case Summation::naive:
+			break;
+		}
+		NaiveSum<T> sum;
+		for (std::size_t i = first; i < last; ++i)
+			sum.add(f(i));
+		return sum.result();
+	}
+
+	// Block until pred() holds. The wait is timed, as the untimed condition_variable::wait of
+	// GCC 12 needs a newer libstdc++ at run time (GLIBCXX_3.4.30) than it otherwise would.
+	template <typename Pred>
+	void wait_until(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, Pred pred)
+	{
+		while (!cv.wait_for(lock, std::chrono::seconds(1), pred)) {}
+	}
+
+	// Threads running tasks in the order submitted. The pool grows to the most threads any call
+	// has asked for, and is never destroyed, so that reductions still run during static
+	// destruction; its idle threads end with the process.
+	class ThreadPool
+	{
+	public:
+		static ThreadPool& instance()
+		{
+			static ThreadPool* const pool = new ThreadPool;
+			return *pool;
+		}
+
+		// Run task on a thread of the pool, started if fewer than `threads` are running
+		void submit(std::function<void()> task, unsigned threads)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				tasks_.push_back(std::move(task));
+				while (workers_.size() < threads)
+					workers_.emplace_back([this] { run(); });
+			}
+			ready_.notify_one();
+		}
+
+	private:
+		ThreadPool() = default;
+		~ThreadPool() = delete;
+
+		void run()
+		{
+			for (;;) {
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					wait_until(ready_, lock, [this] { return !tasks_.empty(); });
+					task = std::move(tasks_.front());
+					tasks_.pop_front();
+				}
+				task();
+			}
+		}
+
+		std::mutex mutex_;
+		std::condition_variable ready_;
+		std::deque<std::function<void()>> tasks_;
+		std::vector<std::thread> workers_;
+	};
+
+	// The helpers of one call. A helper that starts after the call has finished does nothing,
+	// so the call need only wait for those that started.
+	struct Helpers
+	{
+		std::mutex mutex;
+		std::condition_variable idle;
+		std::size_t active = 0;
+		bool closed = false;
+	};
+
+	// Apply chunk(first, last) to each chunk of [0, n), returning the results in chunk order
+	template <typename R, typename F>
+	std::vector<R> for_each_chunk(const Parallel& p, std::size_t n, const F& chunk)
+	{
+		const std::size_t grain = std::max<std::size_t>(p.grain, 1);
+		const std::size_t chunks = std::max<std::size_t>((n + grain - 1) / grain, 1);
+		unsigned threads = p.threads ? p.threads : std::max(std::thread::hardware_concurrency(), 1u);
+		threads = static_cast<unsigned>(std::min<std::size_t>(threads, chunks));
+
+		std::vector<R> results(chunks);
+		std::atomic<std::size_t> next(0);
+		std::exception_ptr error;
+		std::mutex error_mutex;
+		auto work = [&] {
+			for (std::size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks; ) {
+				try {
+					results[c] = chunk(c * grain, std::min(n, (c + 1) * grain));
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if (!error)
+						error = std::current_exception();
+					next.store(chunks, std::memory_order_relaxed);
+				}
+			}
+		};
+
+		if (threads <= 1) {
+			work();
+		}
+		else {
+			const auto helpers = std::make_shared<Helpers>();
+			for (unsigned t = 1; t < threads; ++t) {
+				ThreadPool::instance().submit([helpers, &work] {
+					{
+						std::lock_guard<std::mutex> lock(helpers->mutex);
+						if (helpers->closed)
+							return;
+						++helpers->active;
+					}
+					work();
+					std::lock_guard<std::mutex> lock(helpers->mutex);
+					if (--helpers->active == 0)
+						helpers->idle.notify_all();
+				}, threads - 1);
+			}
+			work();
+			std::unique_lock<std::mutex> lock(helpers->mutex);
+			helpers->closed = true;
+			wait_until(helpers->idle, lock, [&] { return helpers->active == 0; });
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+		return results;
+	}
+
+	template <typename T, typename F>
+	T parallel_sum(const Parallel& p, std::size_t n, const F& f, Summation summation)
+	{
+		const auto partials = for_each_chunk<T>(p, n, [&](std::size_t first, std::size_t last) {
+			return sum_range<T>(first, last, f, summation);
+		});
+		return sum_range<T>(0, partials.size(), [&](std::size_t i) { return partials[i]; }, summation);
+	}
+
+	// A single chunk on the calling thread
+	inline constexpr Parallel sequential{ 1, std::numeric_limits<std::size_t>::max() };
+}
+
+// Sum of a span, as a Unit of the span's type
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> reduce(const Parallel& p, UnitSpan<T,B,P> s, Summation summation = Summation::kahan)
+{
+	using R = std::remove_const_t<T>;
+	const T* data = s.data();
+	return Unit<R,B,P>(detail::parallel_sum<R>(p, s.size(), [data](std::size_t i) { return data[i]; }, summation));
+}
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> reduce(UnitSpan<T,B,P> s, Summation summation = Summation::kahan)
+{
+	return reduce(detail::sequential, s, summation);
+}
+
+// Sum of op(a[i]) or op(a[i], b[i]), with the Unit type op returns
+
+template <typename T, typename B, typename P, typename Op, typename U = decltype(std::declval<Op>()(std::declval<Unit<std::remove_const_t<T>,B,P>>()))>
+U transform_reduce(const Parallel& p, UnitSpan<T,B,P> a, Op op, Summation summation = Summation::kahan)
+{
+	using R = typename U::rep;
+	return U(detail::parallel_sum<R>(p, a.size(), [&](std::size_t i) { return U(op(a[i])).value(); }, summation));
+}
+
+template <typename T, typename B, typename P, typename Op, typename U = decltype(std::declval<Op>()(std::declval<Unit<std::remove_const_t<T>,B,P>>()))>
+U transform_reduce(UnitSpan<T,B,P> a, Op op, Summation summation = Summation::kahan)
+{
+	return transform_reduce(detail::sequential, a, op, summation);
+}
+
+template <typename T1, typename B1, typename P1, typename T2, typename B2, typename P2, typename Op,
+          typename U = decltype(std::declval<Op>()(std::declval<Unit<std::remove_const_t<T1>,B1,P1>>(),
+                                                   std::declval<Unit<std::remove_const_t<T2>,B2,P2>>()))>
+U transform_reduce(const Parallel& p, UnitSpan<T1,B1,P1> a, UnitSpan<T2,B2,P2> b, Op op, Summation summation = Summation::kahan)
+{
+	using R = typename U::rep;
+	assert(a.size() == b.size());
+	return U(detail::parallel_sum<R>(p, a.size(), [&](std::size_t i) { return U(op(a[i], b[i])).value(); }, summation));
+}
+
+template <typename T1, typename B1, typename P1, typename T2, typename B2, typename P2, typename Op,
+          typename U = decltype(std::declval<Op>()(std::declval<Unit<std::remove_const_t<T1>,B1,P1>>(),
+                                                   std::declval<Unit<std::remove_const_t<T2>,B2,P2>>()))>
+U transform_reduce(UnitSpan<T1,B1,P1> a, UnitSpan<T2,B2,P2> b, Op op, Summation summation = Summation::kahan)
+{
+	return transform_reduce(detail::sequential, a, b, op, summation);
+}
+
+// Dot product, e.g. of a velocity and a time span gives a length
+
+template <typename T1, typename B1, typename P1, typename T2, typename B2, typename P2>
+auto dot(const Parallel& p, UnitSpan<T1,B1,P1> a, UnitSpan<T2,B2,P2> b, Summation summation = Summation::kahan)
+{
+	return transform_reduce(p, a, b, [](const auto& x, const auto& y) { return x * y; }, summation);
+}
+
+template <typename T1, typename B1, typename P1, typename T2, typename B2, typename P2>
+auto dot(UnitSpan<T1,B1,P1> a, UnitSpan<T2,B2,P2> b, Summation summation = Summation::kahan)
+{
+	return dot(detail::sequential, a, b, summation);
+}
+
+// Arithmetic mean of a non-empty span
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> mean(const Parallel& p, UnitSpan<T,B,P> s, Summation summation = Summation::kahan)
+{
+	assert(!s.empty());
+	return reduce(p, s, summation) / static_cast<std::remove_const_t<T>>(s.size());
+}
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> mean(UnitSpan<T,B,P> s, Summation summation = Summation::kahan)
+{
+	return mean(detail::sequential, s, summation);
+}
+
+// Least and greatest elements of a non-empty span
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> min(const Parallel& p, UnitSpan<T,B,P> s)
+{
+	using R = std::remove_const_t<T>;
+	assert(!s.empty());
+	const auto partials = detail::for_each_chunk<R>(p, s.size(), [&](std::size_t first, std::size_t last) {
+		return *std::min_element(s.data() + first, s.data() + last);
+	});
+	return Unit<R,B,P>(*std::min_element(partials.begin(), partials.end()));
+}
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> min(UnitSpan<T,B,P> s)
+{
+	return min(detail::sequential, s);
+}
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> max(const Parallel& p, UnitSpan<T,B,P> s)
+{
+	using R = std::remove_const_t<T>;
+	assert(!s.empty());
+	const auto partials = detail::for_each_chunk<R>(p, s.size(), [&](std::size_t first, std::size_t last) {
+		return *std::max_element(s.data() + first, s.data() + last);
+	});
+	return Unit<R,B,P>(*std::max_element(partials.begin(), partials.end()));
+}
+
+template <typename T, typename B, typename P>
+Unit<std::remove_const_t<T>,B,P> max(UnitSpan<T,B,P> s)
+{
+	return max(detail::sequential, s);
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITALGORITHM_H
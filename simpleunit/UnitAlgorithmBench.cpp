@@ -0,0 +1,60 @@
+#include "simpleunit/UnitAlgorithm.h"
+#include <thread>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Sum of 2^24 floats (64 MiB) from 1 to N threads
+
+static void ThreadArgs(benchmark::internal::Benchmark* b)
+{
+	const unsigned n = std::max(std::thread::hardware_concurrency(), 1u);
+	for (unsigned t = 1; t < n; t *= 2)
+		b->Arg(t);
+	b->Arg(n);
+}
+
+static void BM_ReduceOperatorLoop(benchmark::State& state)
+{
+	ArrayOf<Meters> a(1 << 24, Meters(1e-3f));
+	for (auto _ : state) {
+		Meters sum(0);
+		for (const auto& m : a)
+			sum += m;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * a.size() * sizeof(float));
+}
+BENCHMARK(BM_ReduceOperatorLoop)->UseRealTime();
+
+static void BM_Reduce(benchmark::State& state, Summation summation)
+{
+	ArrayOf<Meters> a(1 << 24, Meters(1e-3f));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(reduce(par(state.range(0)), a.span(), summation));
+	state.SetBytesProcessed(int64_t(state.iterations()) * a.size() * sizeof(float));
+}
+BENCHMARK_CAPTURE(BM_Reduce, naive, Summation::naive)->Apply(ThreadArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Reduce, kahan, Summation::kahan)->Apply(ThreadArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Reduce, pairwise, Summation::pairwise)->Apply(ThreadArgs)->UseRealTime();
+
+// Many small reductions, where starting threads for each would cost more than the sum
+static void BM_ReduceSmall(benchmark::State& state)
+{
+	ArrayOf<Meters> a(1 << 16, Meters(1e-3f));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(reduce(par(state.range(0), 1 << 12), a.span()));
+	state.SetBytesProcessed(int64_t(state.iterations()) * a.size() * sizeof(float));
+}
+BENCHMARK(BM_ReduceSmall)->Apply(ThreadArgs)->UseRealTime();
+
+static void BM_Dot(benchmark::State& state)
+{
+	ArrayOf<Meters_Second> v(1 << 24, Meters_Second(2));
+	ArrayOf<Seconds> t(v.size(), Seconds(0.5f));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(dot(par(state.range(0)), v.span(), t.span()));
+	state.SetBytesProcessed(int64_t(state.iterations()) * v.size() * 2 * sizeof(float));
+}
+BENCHMARK(BM_Dot)->Apply(ThreadArgs)->UseRealTime();
@@ -0,0 +1,103 @@
+#include "simpleunit/UnitAlgorithm.h"
+#include <stdexcept>
+#include <type_traits>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+TEST(UnitAlgorithmTest, Reduce)
+{
+	ArrayOf<Meters> a = { Meters(1), Meters(2), Meters(3.5f) };
+	auto sum = reduce(a.span());
+	static_assert(is_same<decltype(sum), Meters>::value, "");
+	EXPECT_FLOAT_EQ(6.5f, sum.value());
+	EXPECT_FLOAT_EQ(6.5f, reduce(a.span(), Summation::naive).value());
+	EXPECT_FLOAT_EQ(6.5f, reduce(a.span(), Summation::pairwise).value());
+
+	EXPECT_FLOAT_EQ(0.f, reduce(ArrayOf<Meters>().span()).value());
+
+	UnitArray<int, BaseRatio<4,3>> b = { Unit<int, BaseRatio<4,3>>(7), Unit<int, BaseRatio<4,3>>(-2) };
+	EXPECT_EQ(5, reduce(b.span()).value());
+
+	ArrayOf<strict::Meters> c = { strict::Meters(1), strict::Meters(2) };
+	static_assert(is_same<decltype(reduce(c.span())), strict::Meters>::value, "");
+	EXPECT_FLOAT_EQ(1.5f, mean(c.span()).value());
+}
+
+TEST(UnitAlgorithmTest, CompensatedSummation)
+{
+	// 1 + n * 1e-8 in float: naive summation never moves from 1
+	const size_t n = 1 << 20;
+	ArrayOf<Meters> a(n + 1, Meters(1e-8f));
+	a[0] = Meters(1);
+
+	const double exact = 1.0 + n * double(1e-8f);
+	EXPECT_FLOAT_EQ(1.f, reduce(a.span(), Summation::naive).value());
+	EXPECT_NEAR(exact, reduce(a.span(), Summation::kahan).value(), 1e-6);
+	EXPECT_NEAR(exact, reduce(a.span(), Summation::pairwise).value(), 1e-5);
+}
+
+TEST(UnitAlgorithmTest, Parallel)
+{
+	const size_t n = 100003;
+	ArrayOf<Centimeters> a(n);
+	for (size_t i = 0; i < n; ++i)
+		a[i] = Centimeters(float(i % 1000) * 0.25f);
+
+	// Chunks are combined in order, so the result doesn't depend on the thread count
+	const auto expected = reduce(par(1, 1000), a.span());
+	for (unsigned threads : { 2u, 3u, 8u, 0u }) {
+		EXPECT_EQ(expected.value(), reduce(par(threads, 1000), a.span()).value());
+		EXPECT_EQ(expected.value(), reduce(par(threads, 1000), a.span(), Summation::pairwise).value());
+		EXPECT_FLOAT_EQ(0.f, min(par(threads, 1000), a.span()).value());
+		EXPECT_FLOAT_EQ(249.75f, max(par(threads, 1000), a.span()).value());
+	}
+	EXPECT_NEAR(12487500.75, double(expected.value()), 1.0);
+	EXPECT_FLOAT_EQ(expected.value() / n, mean(par(4, 1000), a.span()).value());
+}
+
+TEST(UnitAlgorithmTest, ParallelExceptions)
+{
+	ArrayOf<Meters> a(10000, Meters(1));
+
+	// An exception in any chunk reaches the caller, and the pool carries on after
+	auto fails = [](Meters m) -> Meters {
+		if (m.value() > 0)
+			throw std::runtime_error("op failed");
+		return m;
+	};
+	for (int i = 0; i < 3; ++i)
+		EXPECT_THROW(transform_reduce(par(4, 100), a.span(), fails), std::runtime_error);
+	EXPECT_THROW(transform_reduce(a.span(), fails), std::runtime_error);
+	EXPECT_FLOAT_EQ(10000.f, reduce(par(4, 100), a.span()).value());
+
+	// Reductions may run inside the operations of others
+	ArrayOf<Meters> outer(8, Meters(1));
+	auto nested = transform_reduce(par(4, 1), outer.span(), [&](Meters m) { return m * reduce(par(4, 100), a.span()).value(); });
+	EXPECT_FLOAT_EQ(80000.f, nested.value());
+}
+
+TEST(UnitAlgorithmTest, Dimensions)
+{
+	ArrayOf<Meters_Second> v = { Meters_Second(2), Meters_Second(3) };
+	ArrayOf<Minutes> t = { Minutes(1), Minutes(2) };
+
+	// Velocity . time is a length
+	auto d = dot(v.span(), t.span());
+	static_assert(is_same<decltype(d)::base::dim, Meters::base::dim>::value, "");
+	EXPECT_FLOAT_EQ(480.f, d.asVal<Meters>());
+	EXPECT_FLOAT_EQ(480.f, dot(par(2, 1), v.span(), t.span()).asVal<Meters>());
+
+	auto area = transform_reduce(v.span(), t.span(), [](Meters_Second x, Minutes y) { return x * y * Meters(1); });
+	static_assert(is_same<decltype(area)::base::dim, Meters2::base::dim>::value, "");
+	EXPECT_FLOAT_EQ(480.f, area.asVal<Meters2>());
+
+	auto sq = transform_reduce(v.span(), [](Meters_Second x) { return x * x; });
+	EXPECT_FLOAT_EQ(13.f, sq.value());
+
+	EXPECT_FLOAT_EQ(2.5f, mean(v.span()).value());
+	EXPECT_FLOAT_EQ(2.f, min(v.span()).value());
+	EXPECT_FLOAT_EQ(3.f, max(v.span()).value());
+}
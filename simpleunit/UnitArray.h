@@ -0,0 +1,139 @@
+#ifndef SIMPLEUNIT_UNITARRAY_H
+#define SIMPLEUNIT_UNITARRAY_H
+
+#include "simpleunit/Unit.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+namespace sunit {
+
+// Contiguous sequences of units, stored as plain T.
+//
+// Since a Unit<T,B> holds nothing but its T, a buffer of T can be viewed as a buffer of
+// Unit<T,B> in place. `UnitSpan` is a non-owning view over such a buffer (e.g. raw float
+// samples) and `UnitArray` an owning container. Both are typed on the unit's base and scale
+// policy, so a span of Meters does not convert to a span of Seconds, and the elements of a
+// span of StrictScale units rescale no more implicitly than the units do.
+
+template <typename T, typename B, typename P = FinestScale>
+class UnitSpan
+{
+public:
+	using rep = std::remove_const_t<T>;
+	using base = B;
+	using policy = P;
+	using unit_type = Unit<rep, B, P>;
+	using element_type = std::conditional_t<std::is_const<T>::value, const unit_type, unit_type>;
+	using iterator = element_type*;
+	using size_type = std::size_t;
+
+	static_assert(sizeof(unit_type) == sizeof(rep) && alignof(unit_type) == alignof(rep),
+	              "Unit<T,B> must have the layout of T to be viewed over a buffer of T");
+	static_assert(std::is_standard_layout<unit_type>::value, "Unit<T,B> must be standard layout");
+
+	constexpr UnitSpan() = default;
+	constexpr UnitSpan(T* data, size_type size) : data_(data), size_(size) {}
+	UnitSpan(element_type* first, size_type size) : data_(&first->value()), size_(size) {}
+
+	// A span of T converts to a span of const T, but never between bases
+	template <typename X,
+		typename std::enable_if_t<std::is_convertible<X(*)[], T(*)[]>::value, int> = 0>
+	constexpr UnitSpan(const UnitSpan<X,B,P>& other) : data_(other.data()), size_(other.size()) {}
+
+	constexpr T* data() const { return data_; }
+	constexpr size_type size() const { return size_; }
+	constexpr bool empty() const { return size_ == 0; }
+
+	iterator begin() const { return reinterpret_cast<iterator>(data_); }
+	iterator end() const { return begin() + size_; }
+
+	element_type& operator[](size_type i) const { return begin()[i]; }
+	element_type& front() const { return begin()[0]; }
+	element_type& back() const { return begin()[size_ - 1]; }
+
+	constexpr UnitSpan subspan(size_type offset, size_type count) const { return UnitSpan(data_ + offset, count); }
+	constexpr UnitSpan first(size_type count) const { return UnitSpan(data_, count); }
+	constexpr UnitSpan last(size_type count) const { return UnitSpan(data_ + size_ - count, count); }
+
+private:
+	T* data_ = nullptr;
+	size_type size_ = 0;
+};
+
+template <typename T, typename B, typename P = FinestScale>
+class UnitArray
+{
+public:
+	using rep = T;
+	using base = B;
+	using policy = P;
+	using unit_type = Unit<T, B, P>;
+	using iterator = typename UnitSpan<T,B,P>::iterator;
+	using const_iterator = typename UnitSpan<const T,B,P>::iterator;
+	using size_type = std::size_t;
+
+	UnitArray() = default;
+	explicit UnitArray(size_type size) : data_(size) {}
+	UnitArray(size_type size, const unit_type& value) : data_(size, value.value()) {}
+
+	UnitArray(std::initializer_list<unit_type> values) {
+		data_.reserve(values.size());
+		for (const auto& u : values)
+			data_.push_back(u.value());
+	}
+
+	// Copies the raw values of an existing buffer
+	UnitArray(const T* first, size_type size) : data_(first, first + size) {}
+
+	T* data() { return data_.data(); }
+	const T* data() const { return data_.data(); }
+	size_type size() const { return data_.size(); }
+	bool empty() const { return data_.empty(); }
+
+	void resize(size_type size) { data_.resize(size); }
+	void reserve(size_type size) { data_.reserve(size); }
+	void clear() { data_.clear(); }
+	void push_back(const unit_type& u) { data_.push_back(u.value()); }
+
+	UnitSpan<T,B,P> span() { return UnitSpan<T,B,P>(data(), size()); }
+	UnitSpan<const T,B,P> span() const { return UnitSpan<const T,B,P>(data(), size()); }
+
+	operator UnitSpan<T,B,P>() { return span(); }
+	operator UnitSpan<const T,B,P>() const { return span(); }
+
+	iterator begin() { return span().begin(); }
+	iterator end() { return span().end(); }
+	const_iterator begin() const { return span().begin(); }
+	const_iterator end() const { return span().end(); }
+
+	unit_type& operator[](size_type i) { return begin()[i]; }
+	const unit_type& operator[](size_type i) const { return begin()[i]; }
+
+private:
+	std::vector<T> data_;
+};
+
+// Spans and arrays named by their unit, e.g. SpanOf<si::Meters>
+template <typename U> using SpanOf = UnitSpan<typename U::rep, typename U::base, typename U::policy>;
+template <typename U> using ConstSpanOf = UnitSpan<const typename U::rep, typename U::base, typename U::policy>;
+template <typename U> using ArrayOf = UnitArray<typename U::rep, typename U::base, typename U::policy>;
+
+// View a raw buffer as units of U, without copying
+template <typename U>
+constexpr SpanOf<U> unit_span(typename U::rep* data, std::size_t size)
+{
+	return SpanOf<U>(data, size);
+}
+
+template <typename U>
+constexpr ConstSpanOf<U> unit_span(const typename U::rep* data, std::size_t size)
+{
+	return ConstSpanOf<U>(data, size);
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITARRAY_H
@@ -0,0 +1,105 @@
+#include "simpleunit/UnitArray.h"
+#include <numeric>
+#include <type_traits>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	float total_length(ConstSpanOf<Meters> lengths)
+	{
+		float sum = 0;
+		for (const auto& m : lengths)
+			sum += m.value();
+		return sum;
+	}
+}
+
+TEST(UnitArrayTest, Layout)
+{
+	static_assert(sizeof(Meters) == sizeof(float), "");
+	static_assert(sizeof(Unit<double, Length<meter>>) == sizeof(double), "");
+	static_assert(sizeof(Unit<int, Length<meter>>) == sizeof(int), "");
+	static_assert(sizeof(SpanOf<Meters>) == sizeof(float*) + sizeof(size_t), "");
+}
+
+TEST(UnitArrayTest, SpanOverRawBuffer)
+{
+	float samples[] = { 1.f, 2.f, 3.f, 4.f };
+	auto span = unit_span<Meters>(samples, 4);
+
+	// A view, not a copy
+	EXPECT_EQ(samples, span.data());
+	EXPECT_EQ(4u, span.size());
+	EXPECT_EQ(static_cast<void*>(samples), static_cast<void*>(span.begin()));
+	static_assert(is_same<decltype(span[0]), Meters&>::value, "");
+
+	EXPECT_FLOAT_EQ(2.f, span[1].value());
+	EXPECT_FLOAT_EQ(200.f, span[1].asVal<Centimeters>());
+
+	// Writes go through to the buffer
+	span[2] = Centimeters(50);
+	EXPECT_FLOAT_EQ(0.5f, samples[2]);
+	span[3] += Meters(1);
+	EXPECT_FLOAT_EQ(5.f, samples[3]);
+
+	EXPECT_FLOAT_EQ(8.5f, total_length(span));
+	EXPECT_FLOAT_EQ(2.5f, total_length(span.subspan(1, 2)));
+	EXPECT_FLOAT_EQ(1.f, span.first(1).back().value());
+	EXPECT_FLOAT_EQ(5.f, span.last(1).front().value());
+
+	const float* readonly = samples;
+	auto cspan = unit_span<Meters>(readonly, 4);
+	static_assert(is_same<decltype(cspan[0]), const Meters&>::value, "");
+	EXPECT_FLOAT_EQ(8.5f, total_length(cspan));
+}
+
+TEST(UnitArrayTest, SpanTypeSafety)
+{
+	// Spans convert to const, but never between dimensions or scales
+	static_assert(is_convertible<SpanOf<Meters>, ConstSpanOf<Meters>>::value, "");
+	static_assert(!is_convertible<ConstSpanOf<Meters>, SpanOf<Meters>>::value, "");
+	static_assert(!is_convertible<SpanOf<Meters>, SpanOf<Seconds>>::value, "");
+	static_assert(!is_convertible<SpanOf<Meters>, SpanOf<Centimeters>>::value, "");
+	static_assert(!is_convertible<SpanOf<Meters>, UnitSpan<double, Meters::base>>::value, "");
+
+	// ...or between scale policies, and the elements keep the policy of their unit
+	static_assert(!is_convertible<SpanOf<Meters>, SpanOf<strict::Meters>>::value, "");
+	static_assert(is_same<SpanOf<strict::Meters>::unit_type, strict::Meters>::value, "");
+	static_assert(is_same<decltype(ArrayOf<strict::Meters>()[0]), strict::Meters&>::value, "");
+	static_assert(!is_assignable<SpanOf<strict::Meters>::element_type&, Centimeters>::value, "");
+	static_assert(is_assignable<SpanOf<strict::Meters>::element_type&, Meters>::value, "");
+
+	float samples[] = { 1.f, 2.f };
+	auto span = unit_span<Seconds>(samples, 2);
+	//total_length(span);  // Should not compile: no conversion from 'SpanOf<Seconds>' to 'ConstSpanOf<Meters>'
+	EXPECT_EQ(2u, span.size());
+}
+
+TEST(UnitArrayTest, Array)
+{
+	ArrayOf<Meters> a = { Meters(1), Centimeters(250), Meters(3) };
+	EXPECT_EQ(3u, a.size());
+	EXPECT_FLOAT_EQ(2.5f, a[1].value());
+	EXPECT_FLOAT_EQ(6.5f, total_length(a));
+
+	a.push_back(Meters(1));
+	a[0] *= 2;
+	EXPECT_FLOAT_EQ(8.5f, total_length(a));
+	EXPECT_FLOAT_EQ(8.5f, std::accumulate(a.data(), a.data() + a.size(), 0.f));
+
+	ArrayOf<Meters> b(3, Meters(2));
+	EXPECT_FLOAT_EQ(6.f, total_length(b));
+
+	const float raw[] = { 1.f, 2.f };
+	ArrayOf<Meters> c(raw, 2);
+	EXPECT_NE(raw, c.data());
+	EXPECT_FLOAT_EQ(3.f, total_length(c));
+
+	auto span = a.span();
+	span[0] = Meters(0);
+	EXPECT_FLOAT_EQ(0.f, a[0].value());
+}
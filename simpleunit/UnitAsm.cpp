@@ -0,0 +1,197 @@
+// Hot paths of Unit.h next to the raw code they should compile to.
+//
+// Each `unit_<name>` has a hand-written `raw_<name>` doing the same arithmetic on plain
+// float or int. This file is compiled at -O2 to an object, and the asm test disassembles it
+// and fails if any unit_ function has more instructions than its raw_ counterpart. Units
+// are passed and returned by value where the raw code passes a T, as Unit<T,B> has the
+// layout (and so the calling convention) of a T.
+
+#include "simpleunit/Unit.h"
+#include "simpleunit/UnitArray.h"
+
+#include <chrono>
+#include <climits>
+#include <cstddef>
+
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	using IntMeters = Unit<int, Length<meter>>;
+	using IntCentimeters = Unit<int, Length<std::centi>>;
+	using IntMillimeters = Unit<int, Length<std::milli>>;
+	using IntInches = Unit<int, Length<inch>>;
+	using IntMinutes = Unit<int, Time<minute>>;
+	using IntHours = Unit<int, Time<hour>>;
+	using LeftInches = WithPolicy<Inches, LeftScale>;
+	using IntSeconds = Unit<std::chrono::seconds::rep, Time<second>>;
+	using IntMilliseconds = Unit<std::chrono::milliseconds::rep, Time<std::milli>>;
+}
+
+extern "C" {
+
+// Construction and access
+
+Meters unit_construct(float x) { return Meters(x); }
+float raw_construct(float x) { return x; }
+
+float unit_value(Meters m) { return m.value(); }
+float raw_value(float m) { return m; }
+
+Centimeters unit_convert_construct(Meters m) { return Centimeters(m); }
+float raw_convert_construct(float m) { return m * 100.f; }
+
+IntCentimeters unit_convert_construct_int(IntMeters m) { return IntCentimeters(m); }
+int raw_convert_construct_int(int m) { return m * 100; }
+
+// Arithmetic between units
+
+Meters unit_add(Meters a, Meters b) { return a + b; }
+float raw_add(float a, float b) { return a + b; }
+
+Centimeters unit_add_mixed(Centimeters a, Meters b) { return a + b; }
+float raw_add_mixed(float a, float b) { return a + b * 100.f; }
+
+// The finest common scale of inches and centimeters would rescale both
+LeftInches unit_add_left(LeftInches a, Centimeters b) { return a + b; }
+float raw_add_left(float a, float b) { return a + b * 0.39f; }
+
+Meters unit_sub(Meters a, Meters b) { return a - b; }
+float raw_sub(float a, float b) { return a - b; }
+
+Meters2 unit_mul(Meters a, Meters b) { return a * b; }
+float raw_mul(float a, float b) { return a * b; }
+
+m_s unit_div(Meters a, Seconds b) { return a / b; }
+float raw_div(float a, float b) { return a / b; }
+
+float unit_div_ratio(Meters a, Meters b) { return a / b; }
+float raw_div_ratio(float a, float b) { return a / b; }
+
+IntMeters unit_add_int(IntMeters a, IntMeters b) { return a + b; }
+int raw_add_int(int a, int b) { return a + b; }
+
+IntCentimeters unit_add_mixed_int(IntCentimeters a, IntMeters b) { return a + b; }
+int raw_add_mixed_int(int a, int b) { return a + b * 100; }
+
+// Arithmetic with scalars
+
+Meters unit_scalar_mul(Meters a, float y) { return a * y; }
+float raw_scalar_mul(float a, float y) { return a * y; }
+
+Meters unit_scalar_mul_left(float y, Meters a) { return y * a; }
+float raw_scalar_mul_left(float y, float a) { return y * a; }
+
+Meters unit_scalar_div(Meters a, float y) { return a / y; }
+float raw_scalar_div(float a, float y) { return a / y; }
+
+// Compound assignment
+
+void unit_add_assign(Meters* a, Meters b) { *a += b; }
+void raw_add_assign(float* a, float b) { *a += b; }
+
+void unit_sub_assign(Meters* a, Meters b) { *a -= b; }
+void raw_sub_assign(float* a, float b) { *a -= b; }
+
+void unit_mul_assign(Meters* a, float y) { *a *= y; }
+void raw_mul_assign(float* a, float y) { *a *= y; }
+
+void unit_div_assign(Meters* a, float y) { *a /= y; }
+void raw_div_assign(float* a, float y) { *a /= y; }
+
+// Casts
+
+Inches unit_unit_cast(Centimeters a) { return unit_cast<Inches>(a); }
+float raw_unit_cast(float a) { return a * 0.39f; }
+
+Centimeters2 unit_dimension_cast(Meters a) { return dimension_cast<Centimeters2>(a); }
+float raw_dimension_cast(float a) { return a * 100.f; }
+
+float unit_as_val(Meters a) { return a.asVal<Millimeters>(); }
+float raw_as_val(float a) { return a * 1000.f; }
+
+Millimeters unit_as(Meters a) { return a.as<Millimeters>(); }
+float raw_as(float a) { return a * 1000.f; }
+
+IntCentimeters unit_unit_cast_int(IntMeters a) { return unit_cast<IntCentimeters>(a); }
+int raw_unit_cast_int(int a) { return a * 100; }
+
+IntHours unit_unit_cast_int_divide(IntMinutes a) { return unit_cast<IntHours>(a); }
+int raw_unit_cast_int_divide(int a) { return a / 60; }
+
+IntInches unit_unit_cast_int_mul_div(IntCentimeters a) { return unit_cast<IntInches>(a); }
+int raw_unit_cast_int_mul_div(int a) { return static_cast<int>(static_cast<long long>(a) * 39 / 100); }
+
+IntMillimeters unit_unit_cast_saturate(IntMeters a) { return unit_cast<IntMillimeters>(a, saturate); }
+int raw_unit_cast_saturate(int a)
+{
+	int r;
+	if (__builtin_mul_overflow(a, 1000, &r))
+		return a < 0 ? INT_MIN : INT_MAX;
+	return r;
+}
+
+// std::chrono
+
+IntMilliseconds unit_from_duration(std::chrono::milliseconds d) { return d; }
+long raw_from_duration(long d) { return d; }
+
+std::chrono::milliseconds unit_to_duration(IntSeconds s) { return s; }
+long raw_to_duration(long s) { return s * 1000; }
+
+Meters unit_mul_duration(m_s v, std::chrono::duration<float, std::milli> dt) { return v * dt; }
+float raw_mul_duration(float v, float dt) { return v * 0.001f * dt; }
+
+// Loops
+
+float unit_sum(const Meters* a, std::size_t n)
+{
+	Meters sum = 0.f;
+	for (std::size_t i = 0; i < n; ++i)
+		sum += a[i];
+	return sum.value();
+}
+float raw_sum(const float* a, std::size_t n)
+{
+	float sum = 0.f;
+	for (std::size_t i = 0; i < n; ++i)
+		sum += a[i];
+	return sum;
+}
+
+void unit_convert_loop(const Centimeters* in, Inches* out, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = unit_cast<Inches>(in[i]);
+}
+void raw_convert_loop(const float* in, float* out, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = in[i] * 0.39f;
+}
+
+void unit_integrate_loop(Meters* x, const m_s* v, Seconds dt, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		x[i] += v[i] * dt;
+}
+void raw_integrate_loop(float* x, const float* v, float dt, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		x[i] += v[i] * dt;
+}
+
+void unit_span_scale(UnitSpan<float, Meters::base>* s, float y)
+{
+	for (auto& m : *s)
+		m *= y;
+}
+struct RawSpan { float* data; std::size_t size; };
+void raw_span_scale(RawSpan* s, float y)
+{
+	for (float* p = s->data; p != s->data + s->size; ++p)
+		*p *= y;
+}
+
+} // extern "C"
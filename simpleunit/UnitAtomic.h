@@ -0,0 +1,217 @@
+#ifndef SIMPLEUNIT_UNITATOMIC_H
+#define SIMPLEUNIT_UNITATOMIC_H
+
+#include "simpleunit/Unit.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+namespace sunit {
+
+// Units updated from many threads, such as bytes, joules or seconds accounted by workers.
+//
+// `AtomicUnit<T,B>` is a std::atomic<T> typed on its unit. `fetch_add` and `fetch_sub` take
+// any Unit of the same dimensions, converted to B by unit_cast before the update, so other
+// dimensions don't compile. Integral reps add with a single atomic instruction; floating-
+// point reps, which have no atomic add before C++20, with a compare-exchange loop.
+//
+// `ShardedUnit<T,B>` spreads a heavily contended total over cache-line sized shards, one per
+// thread where there are enough, and sums them on read. Each add touches only the adding
+// thread's shard, so adds scale with the number of cores at the cost of slower reads.
+//
+//     sunit::AtomicUnit<double, si::Seconds::base> busy;
+//     busy += si::Minutes(1.5f);                           // 90 s
+//
+//     sunit::ShardedUnit<std::int64_t, si::Meters::base> travelled;
+//     travelled.add(step);                                 // from any thread
+//     auto total = travelled.load();
+
+// The size of the cache lines that shards are padded to, to keep them from false sharing
+constexpr std::size_t cache_line_size = 64;
+
+template <typename T, typename B, typename P = FinestScale>
+class AtomicUnit
+{
+public:
+	using value_type = Unit<T,B,P>;
+
+	static constexpr bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+	AtomicUnit() noexcept : value_(T(0)) {}
+	constexpr AtomicUnit(const value_type& u) noexcept : value_(u.value()) {}
+
+	AtomicUnit(const AtomicUnit&) = delete;
+	AtomicUnit& operator=(const AtomicUnit&) = delete;
+
+	bool is_lock_free() const noexcept { return value_.is_lock_free(); }
+
+	value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+	{
+		return value_type(value_.load(order));
+	}
+
+	void store(const value_type& u, std::memory_order order = std::memory_order_seq_cst) noexcept
+	{
+		value_.store(u.value(), order);
+	}
+
+	value_type exchange(const value_type& u, std::memory_order order = std::memory_order_seq_cst) noexcept
+	{
+		return value_type(value_.exchange(u.value(), order));
+	}
+
+	bool compare_exchange_weak(value_type& expected, const value_type& desired,
+	                           std::memory_order order = std::memory_order_seq_cst) noexcept
+	{
+		return value_.compare_exchange_weak(expected.value(), desired.value(), order);
+	}
+
+	bool compare_exchange_strong(value_type& expected, const value_type& desired,
+	                             std::memory_order order = std::memory_order_seq_cst) noexcept
+	{
+		return value_.compare_exchange_strong(expected.value(), desired.value(), order);
+	}
+
+	// Add u, in any unit of the same dimensions, returning the previous value
+	template <typename X, typename B1, typename P1>
+	value_type fetch_add(const Unit<X,B1,P1>& u, std::memory_order order = std::memory_order_seq_cst) noexcept
+	{
+		return value_type(add(delta(u), order));
+	}
+
+	template <typename X, typename B1, typename P1>
+	value_type fetch_sub(const Unit<X,B1,P1>& u, std::memory_order order = std::memory_order_seq_cst) noexcept
+	{
+		return value_type(add(-delta(u), order));
+	}
+
+	operator value_type() const noexcept { return load(); }
+
+	value_type operator=(const value_type& u) noexcept { store(u); return u; }
+
+	// Compound assignments return the new value, as for std::atomic
+	template <typename X, typename B1, typename P1>
+	value_type operator+=(const Unit<X,B1,P1>& u) noexcept
+	{
+		const T d = delta(u);
+		return value_type(static_cast<T>(add(d, std::memory_order_seq_cst) + d));
+	}
+
+	template <typename X, typename B1, typename P1>
+	value_type operator-=(const Unit<X,B1,P1>& u) noexcept
+	{
+		const T d = delta(u);
+		return value_type(static_cast<T>(add(-d, std::memory_order_seq_cst) - d));
+	}
+
+private:
+	template <typename X, typename B1, typename P1>
+	static constexpr T delta(const Unit<X,B1,P1>& u)
+	{
+		static_assert(B1::dim::code == B::dim::code, "AtomicUnit adds units of its own dimensions");
+		return unit_cast<value_type>(u).value();
+	}
+
+	T add(T d, std::memory_order order) noexcept
+	{
+		if constexpr (std::is_integral<T>::value) {
+			return value_.fetch_add(d, order);
+		}
+		else {
+			T expected = value_.load(std::memory_order_relaxed);
+			while (!value_.compare_exchange_weak(expected, static_cast<T>(expected + d), order, std::memory_order_relaxed))
+				;
+			return expected;
+		}
+	}
+
+	std::atomic<T> value_;
+};
+
+namespace detail
+{
+	// Threads are numbered in the order they first add to any ShardedUnit
+	inline std::size_t thread_number()
+	{
+		static std::atomic<std::size_t> next{ 0 };
+		thread_local const std::size_t number = next.fetch_add(1, std::memory_order_relaxed);
+		return number;
+	}
+}
+
+template <typename T, typename B, typename P = FinestScale>
+class ShardedUnit
+{
+public:
+	using value_type = Unit<T,B,P>;
+
+	// A total over at least `shards` shards, by default one for each hardware thread
+	explicit ShardedUnit(std::size_t shards = std::max(std::thread::hardware_concurrency(), 1u))
+		: mask_(shard_count(shards) - 1), shards_(new Shard[mask_ + 1]) {}
+
+	ShardedUnit(const ShardedUnit&) = delete;
+	ShardedUnit& operator=(const ShardedUnit&) = delete;
+
+	// Add u to this thread's shard. Adds are relaxed: they are atomic, but order nothing else.
+	template <typename X, typename B1, typename P1>
+	void add(const Unit<X,B1,P1>& u) noexcept
+	{
+		shards_[detail::thread_number() & mask_].value.fetch_add(u, std::memory_order_relaxed);
+	}
+
+	template <typename X, typename B1, typename P1>
+	void sub(const Unit<X,B1,P1>& u) noexcept
+	{
+		shards_[detail::thread_number() & mask_].value.fetch_sub(u, std::memory_order_relaxed);
+	}
+
+	template <typename X, typename B1, typename P1>
+	ShardedUnit& operator+=(const Unit<X,B1,P1>& u) noexcept { add(u); return *this; }
+
+	template <typename X, typename B1, typename P1>
+	ShardedUnit& operator-=(const Unit<X,B1,P1>& u) noexcept { sub(u); return *this; }
+
+	// The sum of the shards. Adds made while summing may or may not be included.
+	value_type load() const noexcept
+	{
+		T sum = T(0);
+		for (std::size_t i = 0; i <= mask_; ++i)
+			sum = static_cast<T>(sum + shards_[i].value.load(std::memory_order_relaxed).value());
+		return value_type(sum);
+	}
+
+	// Zero every shard, returning the total taken out of them
+	value_type reset() noexcept
+	{
+		T sum = T(0);
+		for (std::size_t i = 0; i <= mask_; ++i)
+			sum = static_cast<T>(sum + shards_[i].value.exchange(value_type(T(0)), std::memory_order_relaxed).value());
+		return value_type(sum);
+	}
+
+	std::size_t shards() const noexcept { return mask_ + 1; }
+
+private:
+	struct alignas(cache_line_size) Shard {
+		AtomicUnit<T,B,P> value;
+	};
+
+	static std::size_t shard_count(std::size_t shards)
+	{
+		std::size_t n = 1;
+		while (n < shards)
+			n *= 2;
+		return n;
+	}
+
+	std::size_t mask_;
+	std::unique_ptr<Shard[]> shards_;
+};
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITATOMIC_H
@@ -0,0 +1,69 @@
+#include "simpleunit/UnitAtomic.h"
+#include <atomic>
+#include <cstdint>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Adds from 1 to 8 threads to one shared total, as a raw atomic, an AtomicUnit and a
+// ShardedUnit. The atomics contend for one cache line; the shards of a ShardedUnit don't.
+
+using Millis = Unit<int, Time<std::milli>>;
+
+static void BM_AtomicRawDouble(benchmark::State& state)
+{
+	static std::atomic<double> total{ 0 };
+	for (auto _ : state) {
+		double expected = total.load(std::memory_order_relaxed);
+		while (!total.compare_exchange_weak(expected, expected + 0.001, std::memory_order_relaxed))
+			;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AtomicRawDouble)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_AtomicUnitDouble(benchmark::State& state)
+{
+	static AtomicUnit<double, Time<second>> total;
+	for (auto _ : state)
+		total.fetch_add(Millis(1), std::memory_order_relaxed);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AtomicUnitDouble)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_AtomicRawInt64(benchmark::State& state)
+{
+	static std::atomic<std::int64_t> total{ 0 };
+	for (auto _ : state)
+		total.fetch_add(1, std::memory_order_relaxed);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AtomicRawInt64)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_AtomicUnitInt64(benchmark::State& state)
+{
+	static AtomicUnit<std::int64_t, Time<std::milli>> total;
+	for (auto _ : state)
+		total.fetch_add(Millis(1), std::memory_order_relaxed);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AtomicUnitInt64)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ShardedUnitInt64(benchmark::State& state)
+{
+	static ShardedUnit<std::int64_t, Time<std::milli>> total(8);
+	for (auto _ : state)
+		total.add(Millis(1));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShardedUnitInt64)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ShardedUnitDouble(benchmark::State& state)
+{
+	static ShardedUnit<double, Time<second>> total(8);
+	for (auto _ : state)
+		total.add(Millis(1));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShardedUnitDouble)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,99 @@
+#include "simpleunit/UnitAtomic.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+TEST(UnitAtomicTest, AtomicUnit)
+{
+	AtomicUnit<float, Length<meter>> m;
+	EXPECT_EQ(0.f, m.load().value());
+	static_assert(AtomicUnit<double, Length<meter>>::is_always_lock_free, "");
+
+	m.store(Meters(2));
+	EXPECT_EQ(2.f, Meters(m).value());
+	EXPECT_EQ(2.f, m.exchange(Meters(3)).value());
+	EXPECT_EQ(3.f, m.load().value());
+
+	Meters expected(1);
+	EXPECT_FALSE(m.compare_exchange_strong(expected, Meters(4)));
+	EXPECT_EQ(3.f, expected.value());
+	EXPECT_TRUE(m.compare_exchange_strong(expected, Meters(4)));
+	EXPECT_EQ(4.f, m.load().value());
+
+	// Adds of other scales are converted first
+	EXPECT_EQ(4.f, m.fetch_add(Centimeters(50)).value());
+	EXPECT_EQ(4.5f, m.load().value());
+	EXPECT_EQ(4.5f, m.fetch_sub(Millimeters(500)).value());
+	EXPECT_EQ(4.25f, (m += Centimeters(25)).value());
+	EXPECT_EQ(4.25f, m.load().value());
+	EXPECT_EQ(4.f, (m -= Meters(0.25f)).value());
+
+	AtomicUnit<int64_t, Time<milli>> ms(Unit<int64_t, Time<milli>>(5));
+	ms += Seconds(2);
+	ms += Minutes(1);
+	EXPECT_EQ(62005, ms.load().value());
+	EXPECT_EQ(62005, ms.fetch_sub(Unit<int, Time<second>>(62)).value());
+	EXPECT_EQ(5, ms.load().value());
+
+	//m += Seconds(1);  // Should not compile: AtomicUnit adds units of its own dimensions
+}
+
+TEST(UnitAtomicTest, Threads)
+{
+	const int threads = 4, adds = 10000;
+	AtomicUnit<double, Time<second>> seconds;
+	AtomicUnit<int64_t, Length<milli>> millimeters;
+	vector<thread> workers;
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back([&] {
+			for (int i = 0; i < adds; ++i) {
+				seconds += Unit<double, Time<milli>>(500);
+				millimeters.fetch_add(Unit<int, Length<meter>>(1), memory_order_relaxed);
+			}
+		});
+	}
+	for (auto& w : workers)
+		w.join();
+
+	// Halves add exactly, so no add was lost to a race
+	EXPECT_EQ(threads * adds * 0.5, seconds.load().value());
+	EXPECT_EQ(threads * adds * 1000, millimeters.load().value());
+}
+
+TEST(UnitAtomicTest, ShardedUnit)
+{
+	ShardedUnit<int64_t, Length<milli>> s(5);
+	EXPECT_EQ(8u, s.shards());
+	EXPECT_EQ(0, s.load().value());
+	EXPECT_LE(1u, (ShardedUnit<double, Length<meter>>().shards()));
+
+	s.add(Meters(1));
+	s += Centimeters(2);
+	s -= Millimeters(3);
+	EXPECT_EQ(1017, s.load().value());
+
+	const int threads = 8, adds = 10000;
+	ShardedUnit<double, Time<second>> t(2);
+	vector<thread> workers;
+	for (int i = 0; i < threads; ++i) {
+		workers.emplace_back([&] {
+			for (int j = 0; j < adds; ++j) {
+				s.add(Unit<int, Length<milli>>(1));
+				t += Unit<float, Time<milli>>(500);
+			}
+		});
+	}
+	for (auto& w : workers)
+		w.join();
+
+	EXPECT_EQ(1017 + threads * adds, s.load().value());
+	EXPECT_EQ(threads * adds * 0.5, t.load().value());
+
+	EXPECT_EQ(1017 + threads * adds, s.reset().value());
+	EXPECT_EQ(0, s.load().value());
+}
@@ -0,0 +1,250 @@
+#ifndef SIMPLEUNIT_UNITAUDIT_H
+#define SIMPLEUNIT_UNITAUDIT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define SUNIT_AUDIT_DEMANGLE 1
+#else
+#define SUNIT_AUDIT_DEMANGLE 0
+#endif
+
+#if __has_include(<dlfcn.h>)
+#include <dlfcn.h>
+#define SUNIT_AUDIT_DLADDR 1
+#else
+#define SUNIT_AUDIT_DLADDR 0
+#endif
+
+namespace sunit {
+
+// Audit of the conversions a program makes at run time.
+//
+// Building with SUNIT_AUDIT_CONVERSIONS defined (for every translation unit, as it changes
+// Unit.h) makes each dimension_cast and unit_cast that multiplies by a ratio other than one
+// count itself, keyed by its source and target types, its ratio and its call site. This
+// includes the conversions hidden in arithmetic, such as the rescale of the Centimeters in
+// `Meters + Centimeters`. Conversions evaluated at compile time aren't counted. Without the
+// macro this header isn't included, and conversions cost nothing more.
+//
+// The casts and converting constructors take their call site as a trailing default argument,
+// so it is the file and line of the cast or implicit conversion, at any optimisation level.
+// The arithmetic operators can't take one, so in an audit build they are kept out of line
+// and their site is the address they return to. It is named by function and offset where
+// the symbol is exported (link with -rdynamic), and otherwise by module and offset, which
+// `addr2line -e <module> <offset>` maps to a line of a build with -g.
+//
+// A report of the conversions, most frequent first, is printed to stderr at exit.
+//
+//     $ c++ -O2 -g -rdynamic -DSUNIT_AUDIT_CONVERSIONS ...
+//     sunit: 2 conversions audited
+//        count  ratio   from -> to  at
+//      1000000  100/1   Unit<float, BaseUnit<DimPack<1u>>> -> Unit<float, BaseUnit<DimPack<1u>, 1/100>>  at step(Particles&)+0x4c
+//            1  1/100   Unit<float, BaseUnit<DimPack<1u>, 1/100>> -> Unit<float, BaseUnit<DimPack<1u>>>  at src/main.cpp:42
+
+namespace audit {
+
+// Where a conversion was made: a file and line, or failing that a code address
+struct Site {
+	const char* file;
+	unsigned line;
+	const void* address;
+
+	// The call site of a function taking this as a default argument, as std::source_location
+	static constexpr Site current(const char* file = __builtin_FILE(), unsigned line = __builtin_LINE())
+	{
+		return Site{ file, line, nullptr };
+	}
+
+	static constexpr Site caller(const void* address) { return Site{ nullptr, 0, address }; }
+};
+
+struct Conversion {
+	std::string from;           // source unit type, compacted
+	std::string to;             // target unit type, compacted
+	std::intmax_t num, den;     // ratio applied
+	std::string site;           // where the conversion was called from
+	std::uint64_t count;
+};
+
+inline std::string demangle(const char* name)
+{
+#if SUNIT_AUDIT_DEMANGLE
+	int status = 0;
+	char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+	if (status == 0 && demangled) {
+		std::string s(demangled);
+		std::free(demangled);
+		return s;
+	}
+#endif
+	return name;
+}
+
+// A demangled unit type, shortened: `Unit<float, BaseUnit<DimPack<1u>, 1/100>>` for centimeters
+inline std::string compact(std::string name)
+{
+	static const std::regex ns("sunit::"), ratio("std::ratio<(-?[0-9]+)l+, ([0-9]+)l+>"),
+		whole("([0-9-]+)/1\\b"), unit_ratios("(, 1)+ ?>"), policy(", FinestScale>");
+	name = std::regex_replace(name, ns, "");
+	name = std::regex_replace(name, ratio, "$1/$2");
+	name = std::regex_replace(name, whole, "$1");
+	name = std::regex_replace(name, unit_ratios, ">");
+	return std::regex_replace(name, policy, ">");
+}
+
+inline std::string describe_address(const void* address)
+{
+	char offset[32];
+#if SUNIT_AUDIT_DLADDR
+	Dl_info info;
+	if (dladdr(address, &info)) {
+		if (info.dli_sname) {
+			std::snprintf(offset, sizeof(offset), "+0x%zx",
+			              static_cast<std::size_t>(static_cast<const char*>(address) - static_cast<const char*>(info.dli_saddr)));
+			return compact(demangle(info.dli_sname)) + offset;
+		}
+		if (info.dli_fname) {
+			std::snprintf(offset, sizeof(offset), "+0x%zx",
+			              static_cast<std::size_t>(static_cast<const char*>(address) - static_cast<const char*>(info.dli_fbase)));
+			return info.dli_fname + std::string(offset);
+		}
+	}
+#endif
+	std::snprintf(offset, sizeof(offset), "%p", address);
+	return offset;
+}
+
+inline std::string describe_site(std::string_view file, unsigned line, const void* address)
+{
+	if (file.empty())
+		return describe_address(address);
+	return std::string(file) + ":" + std::to_string(line);
+}
+
+class Registry
+{
+public:
+	// The registry is never destroyed, so that conversions made during static destruction are
+	// still counted safely. The report is printed by a handler registered with std::atexit.
+	static Registry& instance()
+	{
+		static Registry* const registry = [] {
+			Registry* r = new Registry;
+			std::atexit(report_at_exit_handler);
+			return r;
+		}();
+		return *registry;
+	}
+
+	void add(const std::type_info& from, const std::type_info& to, std::intmax_t num, std::intmax_t den,
+	         const Site& site, std::uint64_t count)
+	{
+		const std::string_view file = site.file ? site.file : "";
+		std::lock_guard<std::mutex> lock(mutex_);
+		counts_[Key(from, to, num, den, file, site.line, site.address)] += count;
+	}
+
+	// The conversions counted so far, most frequent first
+	std::vector<Conversion> conversions() const
+	{
+		std::vector<Conversion> result;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (const auto& entry : counts_) {
+				const Key& k = entry.first;
+				result.push_back(Conversion{ compact(demangle(std::get<0>(k).name())), compact(demangle(std::get<1>(k).name())),
+				                             std::get<2>(k), std::get<3>(k),
+				                             describe_site(std::get<4>(k), std::get<5>(k), std::get<6>(k)), entry.second });
+			}
+		}
+		std::stable_sort(result.begin(), result.end(),
+			[](const Conversion& a, const Conversion& b) { return a.count > b.count; });
+		return result;
+	}
+
+	std::uint64_t total() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::uint64_t n = 0;
+		for (const auto& entry : counts_)
+			n += entry.second;
+		return n;
+	}
+
+	void reset()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		counts_.clear();
+	}
+
+	void report(std::FILE* out) const
+	{
+		const auto all = conversions();
+		std::fprintf(out, "sunit: %zu conversions audited\n", all.size());
+		if (all.empty())
+			return;
+		std::fprintf(out, "%12s  %-14s  %s\n", "count", "ratio", "from -> to  at");
+		for (const auto& c : all) {
+			char ratio[48];
+			std::snprintf(ratio, sizeof(ratio), "%jd/%jd", c.num, c.den);
+			std::fprintf(out, "%12llu  %-14s  %s -> %s  at %s\n", static_cast<unsigned long long>(c.count),
+			             ratio, c.from.c_str(), c.to.c_str(), c.site.c_str());
+		}
+	}
+
+	// Whether the report is printed at exit
+	void report_at_exit(bool enabled) { report_at_exit_ = enabled; }
+
+private:
+	Registry() = default;
+	~Registry() = delete;
+
+	static void report_at_exit_handler()
+	{
+		Registry& r = instance();
+		if (r.report_at_exit_ && r.total() != 0)
+			r.report(stderr);
+	}
+
+	// Files compare by name, as the same file's name may be at different addresses in
+	// different translation units
+	using Key = std::tuple<std::type_index, std::type_index, std::intmax_t, std::intmax_t,
+	                       std::string_view, unsigned, const void*>;
+
+	mutable std::mutex mutex_;
+	std::map<Key, std::uint64_t> counts_;
+	bool report_at_exit_ = true;
+};
+
+// Count a conversion made at site
+inline void record(const std::type_info& from, const std::type_info& to, std::intmax_t num, std::intmax_t den,
+                   const Site& site, std::uint64_t count = 1)
+{
+	Registry::instance().add(from, to, num, den, site, count);
+}
+
+inline std::vector<Conversion> conversions() { return Registry::instance().conversions(); }
+inline std::uint64_t total() { return Registry::instance().total(); }
+inline void reset() { Registry::instance().reset(); }
+inline void report(std::FILE* out = stderr) { Registry::instance().report(out); }
+
+} // audit
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITAUDIT_H
@@ -0,0 +1,133 @@
+// Built on its own, with SUNIT_AUDIT_CONVERSIONS defined for the whole target
+#include "simpleunit/UnitSimd.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	__attribute__((noinline)) Centimeters add(Meters a, Centimeters b) { return a + b; }
+	__attribute__((noinline)) Centimeters add_again(Meters a, Centimeters b) { return b + a; }
+
+	// Converts while statics are destroyed, after the registry was first used
+	struct ConvertsAtExit {
+		~ConvertsAtExit() { Centimeters cm = Meters(1); (void)cm; }
+	} converts_at_exit;
+}
+
+TEST(UnitAuditTest, Counts)
+{
+	audit::reset();
+	EXPECT_EQ(0u, audit::total());
+
+	// Identity conversions, and conversions at compile time, aren't counted
+	Meters m = Meters(2) + Meters(1);
+	constexpr Meters cm = Centimeters(150);
+	EXPECT_EQ(0u, audit::total());
+
+	// Each rescale of the meters to centimeters in the sum is counted
+	Centimeters sum(0.f);
+	for (int i = 0; i < 1000; ++i)
+		sum += add(m, Centimeters(1));
+	EXPECT_FLOAT_EQ(301000.f, sum.value());
+	for (int i = 0; i < 2; ++i)
+		m = Centimeters(50);
+	EXPECT_EQ(1002u, audit::total());
+
+	const auto all = audit::conversions();
+	ASSERT_EQ(2u, all.size());
+	EXPECT_EQ(1000u, all[0].count);
+	EXPECT_EQ(100, all[0].num);
+	EXPECT_EQ(1, all[0].den);
+	EXPECT_NE(all[0].from, all[0].to);
+	EXPECT_EQ("Unit<float, BaseUnit<DimPack<1u>>>", all[0].from);
+	EXPECT_EQ("Unit<float, BaseUnit<DimPack<1u>, 1/100>>", all[0].to);
+	EXPECT_FALSE(all[0].site.empty());
+	EXPECT_EQ(2u, all[1].count);
+	EXPECT_EQ(1, all[1].num);
+	EXPECT_EQ(100, all[1].den);
+	(void)cm;
+}
+
+TEST(UnitAuditTest, Sites)
+{
+	// Casts and implicit conversions are named by file and line, whatever the optimisation
+	audit::reset();
+	Meters m = Centimeters(50);
+	const unsigned line = __LINE__ - 1;
+	m = unit_cast<Meters>(Centimeters(25));
+	auto all = audit::conversions();
+	ASSERT_EQ(2u, all.size());
+	for (const auto& c : all) {
+		EXPECT_NE(string::npos, c.site.find("UnitAuditTest.cpp:")) << c.site;
+		EXPECT_EQ(1u, c.count);
+	}
+	EXPECT_TRUE(all[0].site.find(":" + to_string(line)) != string::npos ||
+	            all[1].site.find(":" + to_string(line)) != string::npos);
+	EXPECT_NE(all[0].site, all[1].site);
+
+	// The same sum in two functions is two entries, even where the operator isn't inlined
+	audit::reset();
+	add(m, Centimeters(1));
+	add_again(m, Centimeters(1));
+	add(m, Centimeters(1));
+	all = audit::conversions();
+	ASSERT_EQ(2u, all.size());
+	EXPECT_EQ(2u, all[0].count);
+	EXPECT_EQ(1u, all[1].count);
+	EXPECT_NE(all[0].site, all[1].site);
+	audit::reset();
+}
+
+TEST(UnitAuditTest, Statement)
+{
+	// The macro is a single statement, so an else after it belongs to the enclosing if
+	audit::reset();
+	int skipped = 0;
+	for (bool convert : { true, false })
+		if (convert)
+			SUNIT_AUDIT_CONVERSION(Meters, Centimeters, std::ratio<100>, 1, audit::Site::current());
+		else
+			++skipped;
+	EXPECT_EQ(1, skipped);
+	EXPECT_EQ(1u, audit::total());
+	audit::reset();
+}
+
+TEST(UnitAuditTest, Spans)
+{
+	audit::reset();
+	vector<float> cm(100, 1.f), m(100);
+	unit_cast(unit_span<Centimeters>(cm.data(), cm.size()), unit_span<Meters>(m.data(), m.size()));
+	unit_cast(unit_span<Meters>(m.data(), m.size()), unit_span<Meters>(m.data(), m.size()));
+	EXPECT_EQ(100u, audit::total());
+	ASSERT_EQ(1u, audit::conversions().size());
+	EXPECT_EQ(100, audit::conversions()[0].den);
+}
+
+TEST(UnitAuditTest, Report)
+{
+	audit::reset();
+	Meters m = unit_cast<Meters>(Unit<int, Length<std::milli>>(1500));
+	EXPECT_FLOAT_EQ(1.5f, m.value());
+
+	std::FILE* f = std::tmpfile();
+	ASSERT_TRUE(f);
+	audit::report(f);
+	std::rewind(f);
+	char buffer[4096] = {};
+	const size_t n = std::fread(buffer, 1, sizeof(buffer) - 1, f);
+	std::fclose(f);
+	const string report(buffer, n);
+	EXPECT_EQ(0u, report.find("sunit: 1 conversions audited\n"));
+	EXPECT_NE(string::npos, report.find("1/1000"));
+	EXPECT_NE(string::npos, report.find(" at "));
+
+	// Keep the test's output free of the report at exit
+	audit::reset();
+}
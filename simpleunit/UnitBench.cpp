@@ -0,0 +1,199 @@
+#include "simpleunit/Unit.h"
+#include <climits>
+#include <stdexcept>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Every constructor, operator and cast of Unit.h next to the raw float or int code it should
+// compile to. Each op is run in scalar form (one op per iteration, on values the compiler
+// can't see through) and in loop form (over arrays), as `<op>_raw` and `<op>_unit`.
+// The simpleunit_asm test checks the same pairs instruction by instruction.
+
+namespace
+{
+	using IntMeters = Unit<int, Length<meter>>;
+	using IntCentimeters = Unit<int, Length<std::centi>>;
+	using IntMillimeters = Unit<int, Length<std::milli>>;
+	using IntInches = Unit<int, Length<inch>>;
+	using IntMinutes = Unit<int, Time<minute>>;
+	using IntHours = Unit<int, Time<hour>>;
+	using LeftInches = WithPolicy<Inches, LeftScale>;
+
+	// Construction
+
+	const auto construct_raw = [](float a, float) { return a; };
+	const auto construct_unit = [](float a, float) { return Meters(a); };
+
+	const auto convert_construct_raw = [](float a, float) { return a * 100.f; };
+	const auto convert_construct_unit = [](Meters a, float) { return Centimeters(a); };
+
+	const auto convert_construct_int_raw = [](int a, int) { return a * 100; };
+	const auto convert_construct_int_unit = [](IntMeters a, int) { return IntCentimeters(a); };
+
+	// Arithmetic between units
+
+	const auto add_raw = [](float a, float b) { return a + b; };
+	const auto add_unit = [](Meters a, Meters b) { return a + b; };
+
+	const auto add_mixed_raw = [](float a, float b) { return a + b * 100.f; };
+	const auto add_mixed_unit = [](Centimeters a, Meters b) { return a + b; };
+
+	const auto add_finest_raw = [](float a, float b) { return a * 100.f + b * 39.f; };
+	const auto add_finest_unit = [](Inches a, Centimeters b) { return a + b; };
+
+	const auto add_left_raw = [](float a, float b) { return a + b * 0.39f; };
+	const auto add_left_unit = [](LeftInches a, Centimeters b) { return a + b; };
+
+	const auto sub_raw = [](float a, float b) { return a - b; };
+	const auto sub_unit = [](Meters a, Meters b) { return a - b; };
+
+	const auto mul_raw = [](float a, float b) { return a * b; };
+	const auto mul_unit = [](Meters a, Meters b) { return a * b; };
+
+	const auto div_raw = [](float a, float b) { return a / b; };
+	const auto div_unit = [](Meters a, Seconds b) { return a / b; };
+
+	const auto div_ratio_raw = [](float a, float b) { return a / b; };
+	const auto div_ratio_unit = [](Meters a, Meters b) { return a / b; };
+
+	const auto add_int_raw = [](int a, int b) { return a + b; };
+	const auto add_int_unit = [](IntMeters a, IntMeters b) { return a + b; };
+
+	const auto add_mixed_int_raw = [](int a, int b) { return a + b * 100; };
+	const auto add_mixed_int_unit = [](IntCentimeters a, IntMeters b) { return a + b; };
+
+	// Arithmetic with scalars
+
+	const auto scalar_mul_raw = [](float a, float y) { return a * y; };
+	const auto scalar_mul_unit = [](Meters a, float y) { return a * y; };
+
+	const auto scalar_mul_left_raw = [](float a, float y) { return y * a; };
+	const auto scalar_mul_left_unit = [](Meters a, float y) { return y * a; };
+
+	const auto scalar_div_raw = [](float a, float y) { return a / y; };
+	const auto scalar_div_unit = [](Meters a, float y) { return a / y; };
+
+	// Compound assignment
+
+	const auto add_assign_raw = [](float a, float b) { a += b; return a; };
+	const auto add_assign_unit = [](Meters a, Meters b) { a += b; return a; };
+
+	const auto sub_assign_raw = [](float a, float b) { a -= b; return a; };
+	const auto sub_assign_unit = [](Meters a, Meters b) { a -= b; return a; };
+
+	const auto mul_assign_raw = [](float a, float y) { a *= y; return a; };
+	const auto mul_assign_unit = [](Meters a, float y) { a *= y; return a; };
+
+	const auto div_assign_raw = [](float a, float y) { a /= y; return a; };
+	const auto div_assign_unit = [](Meters a, float y) { a /= y; return a; };
+
+	// Casts
+
+	const auto unit_cast_raw = [](float a, float) { return a * 0.39f; };
+	const auto unit_cast_unit = [](Centimeters a, float) { return unit_cast<Inches>(a); };
+
+	const auto dimension_cast_raw = [](float a, float) { return a * 100.f; };
+	const auto dimension_cast_unit = [](Meters a, float) { return dimension_cast<Centimeters2>(a); };
+
+	const auto as_raw = [](float a, float) { return a * 1000.f; };
+	const auto as_unit = [](Meters a, float) { return a.as<Millimeters>(); };
+
+	const auto unit_cast_int_raw = [](int a, int) { return a * 100; };
+	const auto unit_cast_int_unit = [](IntMeters a, int) { return unit_cast<IntCentimeters>(a); };
+
+	const auto unit_cast_int_divide_raw = [](int a, int) { return a / 60; };
+	const auto unit_cast_int_divide_unit = [](IntMinutes a, int) { return unit_cast<IntHours>(a); };
+
+	const auto unit_cast_int_mul_div_raw = [](int a, int) { return static_cast<int>(static_cast<long long>(a) * 39 / 100); };
+	const auto unit_cast_int_mul_div_unit = [](IntCentimeters a, int) { return unit_cast<IntInches>(a); };
+
+	const auto unit_cast_saturate_raw = [](int a, int) {
+		int r;
+		if (__builtin_mul_overflow(a, 1000, &r))
+			return a < 0 ? INT_MIN : INT_MAX;
+		return r;
+	};
+	const auto unit_cast_saturate_unit = [](IntMeters a, int) { return unit_cast<IntMillimeters>(a, saturate); };
+
+	const auto unit_cast_checked_raw = [](int a, int) {
+		int r;
+		if (__builtin_mul_overflow(a, 1000, &r))
+			throw std::overflow_error("overflow");
+		return r;
+	};
+	const auto unit_cast_checked_unit = [](IntMeters a, int) { return unit_cast<IntMillimeters>(a, checked); };
+}
+
+template <typename F, typename X, typename Y>
+static void BM_Scalar(benchmark::State& state, F f, X a, Y b)
+{
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a);
+		benchmark::DoNotOptimize(b);
+		auto r = f(a, b);
+		benchmark::DoNotOptimize(r);
+	}
+}
+
+template <typename F, typename X, typename Y>
+static void BM_Loop(benchmark::State& state, F f, X a, Y b)
+{
+	const size_t n = state.range(0);
+	std::vector<X> lhs(n, a);
+	std::vector<Y> rhs(n, b);
+	std::vector<decltype(f(a, b))> out(n, f(a, b));
+	for (auto _ : state) {
+		for (size_t i = 0; i < n; ++i)
+			out[i] = f(lhs[i], rhs[i]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * n);
+}
+
+static void LoopArgs(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 10)->Arg(1 << 16);
+}
+
+#define SUNIT_BENCH_OP(op, raw_a, raw_b, unit_a, unit_b) \
+	BENCHMARK_CAPTURE(BM_Scalar, op##_raw, op##_raw, raw_a, raw_b); \
+	BENCHMARK_CAPTURE(BM_Scalar, op##_unit, op##_unit, unit_a, unit_b); \
+	BENCHMARK_CAPTURE(BM_Loop, op##_raw, op##_raw, raw_a, raw_b)->Apply(LoopArgs); \
+	BENCHMARK_CAPTURE(BM_Loop, op##_unit, op##_unit, unit_a, unit_b)->Apply(LoopArgs)
+
+SUNIT_BENCH_OP(construct, 3.f, 0.f, 3.f, 0.f);
+SUNIT_BENCH_OP(convert_construct, 3.f, 0.f, Meters(3), 0.f);
+SUNIT_BENCH_OP(convert_construct_int, 3, 0, IntMeters(3), 0);
+
+SUNIT_BENCH_OP(add, 3.f, 2.f, Meters(3), Meters(2));
+SUNIT_BENCH_OP(add_mixed, 3.f, 2.f, Centimeters(3), Meters(2));
+SUNIT_BENCH_OP(add_finest, 3.f, 2.f, Inches(3), Centimeters(2));
+SUNIT_BENCH_OP(add_left, 3.f, 2.f, LeftInches(3), Centimeters(2));
+SUNIT_BENCH_OP(sub, 3.f, 2.f, Meters(3), Meters(2));
+SUNIT_BENCH_OP(mul, 3.f, 2.f, Meters(3), Meters(2));
+SUNIT_BENCH_OP(div, 3.f, 2.f, Meters(3), Seconds(2));
+SUNIT_BENCH_OP(div_ratio, 3.f, 2.f, Meters(3), Meters(2));
+SUNIT_BENCH_OP(add_int, 3, 2, IntMeters(3), IntMeters(2));
+SUNIT_BENCH_OP(add_mixed_int, 3, 2, IntCentimeters(3), IntMeters(2));
+
+SUNIT_BENCH_OP(scalar_mul, 3.f, 2.f, Meters(3), 2.f);
+SUNIT_BENCH_OP(scalar_mul_left, 3.f, 2.f, Meters(3), 2.f);
+SUNIT_BENCH_OP(scalar_div, 3.f, 2.f, Meters(3), 2.f);
+
+SUNIT_BENCH_OP(add_assign, 3.f, 2.f, Meters(3), Meters(2));
+SUNIT_BENCH_OP(sub_assign, 3.f, 2.f, Meters(3), Meters(2));
+SUNIT_BENCH_OP(mul_assign, 3.f, 2.f, Meters(3), 2.f);
+SUNIT_BENCH_OP(div_assign, 3.f, 2.f, Meters(3), 2.f);
+
+SUNIT_BENCH_OP(unit_cast, 3.f, 0.f, Centimeters(3), 0.f);
+SUNIT_BENCH_OP(dimension_cast, 3.f, 0.f, Meters(3), 0.f);
+SUNIT_BENCH_OP(as, 3.f, 0.f, Meters(3), 0.f);
+SUNIT_BENCH_OP(unit_cast_int, 3, 0, IntMeters(3), 0);
+SUNIT_BENCH_OP(unit_cast_int_divide, 300, 0, IntMinutes(300), 0);
+SUNIT_BENCH_OP(unit_cast_int_mul_div, 300, 0, IntCentimeters(300), 0);
+SUNIT_BENCH_OP(unit_cast_saturate, 3, 0, IntMeters(3), 0);
+SUNIT_BENCH_OP(unit_cast_checked, 3, 0, IntMeters(3), 0);
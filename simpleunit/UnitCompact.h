@@ -0,0 +1,381 @@
+#ifndef SIMPLEUNIT_UNITCOMPACT_H
+#define SIMPLEUNIT_UNITCOMPACT_H
+
+#include "simpleunit/UnitArray.h"
+#include "simpleunit/UnitSimd.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace sunit {
+
+// 16-bit reps for storing large numbers of quantities at half the size of float.
+//
+// `bfloat16` keeps the range of float with 8 bits of precision, about 3 significant digits.
+// `half`, where the compiler has a _Float16 the CPU converts, has 11 bits over a range of +-65504. A std::int16_t
+// rep under a fine base, such as Length<std::milli>, is fixed-point with its scale in the
+// type. Units of these reps convert like any other, with their dimensions checked at compile
+// time, but arithmetic on them is carried out in float (see `compute_type`), just as
+// arithmetic on short is carried out in int.
+//
+// `widen` and `narrow` convert whole spans between a storage rep and float, converting units
+// on the way. Narrowing rounds to nearest, ties to even, and saturates an int16 rep.
+//
+//     ArrayOf<Unit<bfloat16, Length<>>> stored(n);
+//     sunit::narrow(samples.span(), stored.span());      // float cm to bfloat16 m
+//     sunit::widen(stored.span(), work.span());           // and back to float
+
+// The upper half of an IEEE float
+class bfloat16
+{
+public:
+	bfloat16() = default;
+	bfloat16(float f) : bits_(from_float(f)) {}
+
+	operator float() const { return to_float(bits_); }
+
+	static constexpr bfloat16 from_bits(std::uint16_t bits) { return bfloat16(bits, 0); }
+	constexpr std::uint16_t bits() const { return bits_; }
+
+	// Rounded to nearest, ties to even. NaNs stay NaN.
+	static std::uint16_t from_float(float f)
+	{
+		std::uint32_t u;
+		std::memcpy(&u, &f, sizeof(u));
+		if (f != f)
+			return static_cast<std::uint16_t>(u >> 16 | 0x40);
+		return static_cast<std::uint16_t>((u + 0x7FFF + (u >> 16 & 1)) >> 16);
+	}
+
+	static float to_float(std::uint16_t bits)
+	{
+		const std::uint32_t u = static_cast<std::uint32_t>(bits) << 16;
+		float f;
+		std::memcpy(&f, &u, sizeof(f));
+		return f;
+	}
+
+	bfloat16& operator+=(float x) { return *this = *this + x; }
+	bfloat16& operator-=(float x) { return *this = *this - x; }
+	bfloat16& operator*=(float x) { return *this = *this * x; }
+	bfloat16& operator/=(float x) { return *this = *this / x; }
+
+private:
+	constexpr bfloat16(std::uint16_t bits, int) : bits_(bits) {}
+
+	std::uint16_t bits_;
+};
+
+template <>
+struct treat_as_floating_point<bfloat16> : std::true_type {};
+
+template <>
+struct compute_type<bfloat16> { using type = float; };
+
+// Only where conversions to and from float are single instructions: on x86 without F16C
+// (e.g. -mf16c or -march=haswell), each conversion is a call into libgcc
+#if defined(__FLT16_MAX__) && (defined(__F16C__) || !SUNIT_SIMD_X86)
+#define SUNIT_HALF 1
+
+using half = _Float16;
+
+template <>
+struct treat_as_floating_point<half> : std::true_type {};
+
+template <>
+struct compute_type<half> { using type = float; };
+#else
+#define SUNIT_HALF 0
+#endif
+
+namespace simd {
+
+// out[i] = in[i] * factor, from a storage rep to float
+
+inline void widen_scalar(const bfloat16* in, float* out, std::size_t n, float factor)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = bfloat16::to_float(in[i].bits()) * factor;
+}
+
+inline void widen_scalar(const std::int16_t* in, float* out, std::size_t n, float factor)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = static_cast<float>(in[i]) * factor;
+}
+
+#if SUNIT_HALF
+inline void widen_scalar(const half* in, float* out, std::size_t n, float factor)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = static_cast<float>(in[i]) * factor;
+}
+#endif
+
+// out[i] = in[i] * factor, from float to a storage rep. The int16 kernels clamp before
+// rounding, so out of range values saturate and NaN becomes the minimum.
+
+inline void narrow_scalar(const float* in, bfloat16* out, std::size_t n, float factor)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = bfloat16::from_bits(bfloat16::from_float(in[i] * factor));
+}
+
+inline void narrow_scalar(const float* in, std::int16_t* out, std::size_t n, float factor)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		float x = in[i] * factor;
+		x = x > -32768.f ? x : -32768.f;
+		x = x < 32767.f ? x : 32767.f;
+		out[i] = static_cast<std::int16_t>(std::nearbyint(x));
+	}
+}
+
+#if SUNIT_HALF
+inline void narrow_scalar(const float* in, half* out, std::size_t n, float factor)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = static_cast<half>(in[i] * factor);
+}
+#endif
+
+#if SUNIT_SIMD_X86
+
+// Every CPU with AVX2 also has F16C, so the half kernels share the AVX2 dispatch
+
+__attribute__((target("avx2")))
+inline void widen_avx2(const bfloat16* in, float* out, std::size_t n, float factor)
+{
+	const __m256 f = _mm256_set1_ps(factor);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m256i u = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_castsi256_ps(_mm256_slli_epi32(u, 16)), f));
+	}
+	widen_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("avx2")))
+inline void widen_avx2(const std::int16_t* in, float* out, std::size_t n, float factor)
+{
+	const __m256 f = _mm256_set1_ps(factor);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), f));
+	}
+	widen_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("avx2")))
+inline void narrow_avx2(const float* in, bfloat16* out, std::size_t n, float factor)
+{
+	const __m256 f = _mm256_set1_ps(factor);
+	const __m256i bias = _mm256_set1_epi32(0x7FFF);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i quiet = _mm256_set1_epi32(0x40);
+	std::size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m256i lanes[2];
+		for (int h = 0; h < 2; ++h) {
+			const __m256 x = _mm256_mul_ps(_mm256_loadu_ps(in + i + 8 * h), f);
+			const __m256i u = _mm256_castps_si256(x);
+			const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), one);
+			const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(u, bias), lsb), 16);
+			const __m256i nan = _mm256_or_si256(_mm256_srli_epi32(u, 16), quiet);
+			lanes[h] = _mm256_blendv_epi8(rounded, nan, _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q)));
+		}
+		// packus works within 128-bit lanes, so the quarters are put back in order after
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lanes[0], lanes[1]), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+	}
+	narrow_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("avx2")))
+inline void narrow_avx2(const float* in, std::int16_t* out, std::size_t n, float factor)
+{
+	const __m256 f = _mm256_set1_ps(factor);
+	const __m256 lo = _mm256_set1_ps(-32768.f);
+	const __m256 hi = _mm256_set1_ps(32767.f);
+	std::size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), f), lo), hi);
+		const __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), f), lo), hi);
+		const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	narrow_scalar(in + i, out + i, n - i, factor);
+}
+
+#if SUNIT_HALF
+__attribute__((target("avx2,f16c")))
+inline void widen_avx2(const half* in, float* out, std::size_t n, float factor)
+{
+	const __m256 f = _mm256_set1_ps(factor);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))), f));
+	widen_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("avx2,f16c")))
+inline void narrow_avx2(const float* in, half* out, std::size_t n, float factor)
+{
+	const __m256 f = _mm256_set1_ps(factor);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m128i h = _mm256_cvtps_ph(_mm256_mul_ps(_mm256_loadu_ps(in + i), f), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+	}
+	narrow_scalar(in + i, out + i, n - i, factor);
+}
+#endif
+
+#endif
+
+template <typename S>
+using WidenKernel = void (*)(const S*, float*, std::size_t, float);
+
+template <typename S>
+using NarrowKernel = void (*)(const float*, S*, std::size_t, float);
+
+// The kernel for isa, or the scalar loop if the CPU doesn't support isa
+template <typename S>
+inline WidenKernel<S> widen_kernel(Isa isa)
+{
+#if SUNIT_SIMD_X86
+	if ((isa == Isa::avx2 || isa == Isa::avx512) && supported(isa) && supported(Isa::avx2))
+		return static_cast<WidenKernel<S>>(widen_avx2);
+#else
+	(void)isa;
+#endif
+	return static_cast<WidenKernel<S>>(widen_scalar);
+}
+
+template <typename S>
+inline NarrowKernel<S> narrow_kernel(Isa isa)
+{
+#if SUNIT_SIMD_X86
+	if ((isa == Isa::avx2 || isa == Isa::avx512) && supported(isa) && supported(Isa::avx2))
+		return static_cast<NarrowKernel<S>>(narrow_avx2);
+#else
+	(void)isa;
+#endif
+	return static_cast<NarrowKernel<S>>(narrow_scalar);
+}
+
+template <typename S>
+inline void widen(const S* in, float* out, std::size_t n, float factor, Isa isa)
+{
+	widen_kernel<S>(isa)(in, out, n, factor);
+}
+
+template <typename S>
+inline void widen(const S* in, float* out, std::size_t n, float factor)
+{
+	static const WidenKernel<S> kernel = widen_kernel<S>(best_isa());
+	kernel(in, out, n, factor);
+}
+
+template <typename S>
+inline void narrow(const float* in, S* out, std::size_t n, float factor, Isa isa)
+{
+	narrow_kernel<S>(isa)(in, out, n, factor);
+}
+
+template <typename S>
+inline void narrow(const float* in, S* out, std::size_t n, float factor)
+{
+	static const NarrowKernel<S> kernel = narrow_kernel<S>(best_isa());
+	kernel(in, out, n, factor);
+}
+
+} // simd
+
+namespace detail
+{
+	template <typename S>
+	using IsCompact = std::integral_constant<bool,
+		std::is_same<S, bfloat16>::value ||
+#if SUNIT_HALF
+		std::is_same<S, half>::value ||
+#endif
+		std::is_same<S, std::int16_t>::value>;
+
+	template <typename R>
+	constexpr float ratio_factor() { return static_cast<float>(static_cast<long double>(R::num) / R::den); }
+}
+
+// dst[i] = unit_cast<Unit<float,B>>(src[i]), from a storage rep. `dst` must have the size of `src`.
+template <typename X, typename B1, typename P1, typename B, typename P>
+void widen(UnitSpan<X,B1,P1> src, UnitSpan<float,B,P> dst)
+{
+	using S = std::remove_const_t<X>;
+	static_assert(detail::IsCompact<S>::value, "widen converts from bfloat16, half or std::int16_t");
+	static_assert(B1::dim::code == B::dim::code, "widen converts between units of equal dimensions");
+
+	assert(src.size() == dst.size());
+	simd::widen(src.data(), dst.data(), src.size(), detail::ratio_factor<BaseConversion<B1,B>>());
+}
+
+// dst[i] = src[i] in the units of dst, rounded to nearest and, for std::int16_t, saturated.
+// `dst` must have the size of `src`.
+template <typename X, typename B1, typename P1, typename S, typename B, typename P>
+void narrow(UnitSpan<X,B1,P1> src, UnitSpan<S,B,P> dst)
+{
+	static_assert(std::is_same<std::remove_const_t<X>, float>::value, "narrow converts from float");
+	static_assert(detail::IsCompact<S>::value, "narrow converts to bfloat16, half or std::int16_t");
+	static_assert(B1::dim::code == B::dim::code, "narrow converts between units of equal dimensions");
+
+	assert(src.size() == dst.size());
+	simd::narrow(src.data(), dst.data(), src.size(), detail::ratio_factor<BaseConversion<B1,B>>());
+}
+
+} // sunit
+
+namespace std {
+
+template <>
+class numeric_limits<sunit::bfloat16> {
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr bool is_signed = true;
+	static constexpr bool is_integer = false;
+	static constexpr bool is_exact = false;
+	static constexpr bool has_infinity = true;
+	static constexpr bool has_quiet_NaN = true;
+	static constexpr bool has_signaling_NaN = true;
+	static constexpr float_denorm_style has_denorm = denorm_present;
+	static constexpr float_round_style round_style = round_to_nearest;
+	static constexpr bool is_iec559 = false;
+	static constexpr bool is_bounded = true;
+	static constexpr bool is_modulo = false;
+	static constexpr int digits = 8;
+	static constexpr int digits10 = 2;
+	static constexpr int max_digits10 = 4;
+	static constexpr int radix = 2;
+	static constexpr int min_exponent = -125;
+	static constexpr int min_exponent10 = -37;
+	static constexpr int max_exponent = 128;
+	static constexpr int max_exponent10 = 38;
+
+	static constexpr sunit::bfloat16 min() noexcept { return sunit::bfloat16::from_bits(0x0080); }
+	static constexpr sunit::bfloat16 lowest() noexcept { return sunit::bfloat16::from_bits(0xFF7F); }
+	static constexpr sunit::bfloat16 max() noexcept { return sunit::bfloat16::from_bits(0x7F7F); }
+	static constexpr sunit::bfloat16 epsilon() noexcept { return sunit::bfloat16::from_bits(0x3C00); }
+	static constexpr sunit::bfloat16 round_error() noexcept { return sunit::bfloat16::from_bits(0x3F00); }
+	static constexpr sunit::bfloat16 infinity() noexcept { return sunit::bfloat16::from_bits(0x7F80); }
+	static constexpr sunit::bfloat16 quiet_NaN() noexcept { return sunit::bfloat16::from_bits(0x7FC0); }
+	static constexpr sunit::bfloat16 signaling_NaN() noexcept { return sunit::bfloat16::from_bits(0x7FA0); }
+	static constexpr sunit::bfloat16 denorm_min() noexcept { return sunit::bfloat16::from_bits(0x0001); }
+};
+
+} // std
+
+#endif // SIMPLEUNIT_UNITCOMPACT_H
@@ -0,0 +1,112 @@
+#include "simpleunit/UnitCompact.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Widening storage reps to float and narrowing back, against float-to-float conversion, from
+// L1-resident arrays up to DRAM. Narrowing benchmarks report the largest error of a round trip
+// relative to values of at least one stored unit, and the largest absolute error in that unit.
+
+static void CompactArgs(benchmark::internal::Benchmark* b)
+{
+	for (long n = 1 << 10; n <= 1 << 24; n <<= 4)
+		b->Arg(n);
+}
+
+static std::vector<float> samples(std::size_t n)
+{
+	std::vector<float> v(n);
+	for (std::size_t i = 0; i < n; ++i)
+		v[i] = 0.1f + 30.f * std::sin(0.001f * i);
+	return v;
+}
+
+static void BM_CompactFloat(benchmark::State& state)
+{
+	const std::vector<float> in = samples(state.range(0));
+	std::vector<float> out(in.size());
+	for (auto _ : state) {
+		simd::scale(in.data(), out.data(), in.size(), 0.01f);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * 2 * sizeof(float));
+}
+BENCHMARK(BM_CompactFloat)->Apply(CompactArgs);
+
+template <typename S>
+static void CompactWiden(benchmark::State& state, simd::Isa isa)
+{
+	if (!simd::supported(isa)) {
+		state.SkipWithError("instruction set not supported");
+		return;
+	}
+	const std::vector<float> wide = samples(state.range(0));
+	std::vector<S> in(wide.size());
+	simd::narrow(wide.data(), in.data(), in.size(), 100.f, isa);
+	std::vector<float> out(in.size());
+	for (auto _ : state) {
+		simd::widen(in.data(), out.data(), in.size(), 0.01f, isa);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * (sizeof(S) + sizeof(float)));
+}
+
+template <typename S>
+static void CompactNarrow(benchmark::State& state, simd::Isa isa)
+{
+	if (!simd::supported(isa)) {
+		state.SkipWithError("instruction set not supported");
+		return;
+	}
+	const std::vector<float> in = samples(state.range(0));
+	std::vector<S> out(in.size());
+	for (auto _ : state) {
+		simd::narrow(in.data(), out.data(), in.size(), 100.f, isa);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * (sizeof(S) + sizeof(float)));
+
+	// Quantisation error of the round trip, of values in meters stored in centimeters
+	std::vector<float> back(in.size());
+	simd::widen(out.data(), back.data(), out.size(), 0.01f, isa);
+	double relative = 0, absolute = 0;
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		const double error = std::abs(double(back[i]) - in[i]);
+		absolute = std::max(absolute, error * 100);
+		if (std::abs(in[i]) >= 0.01f)
+			relative = std::max(relative, error / std::abs(in[i]));
+	}
+	state.counters["max_rel_error"] = relative;
+	state.counters["max_abs_error_cm"] = absolute;
+}
+
+// Google Benchmark can't capture arguments of a template, so each rep gets a wrapper
+
+static void BM_WidenBfloat16(benchmark::State& state, simd::Isa isa) { CompactWiden<bfloat16>(state, isa); }
+static void BM_WidenInt16(benchmark::State& state, simd::Isa isa) { CompactWiden<int16_t>(state, isa); }
+static void BM_NarrowBfloat16(benchmark::State& state, simd::Isa isa) { CompactNarrow<bfloat16>(state, isa); }
+static void BM_NarrowInt16(benchmark::State& state, simd::Isa isa) { CompactNarrow<int16_t>(state, isa); }
+BENCHMARK_CAPTURE(BM_WidenBfloat16, scalar, simd::Isa::scalar)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_WidenBfloat16, avx2, simd::Isa::avx2)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_WidenInt16, scalar, simd::Isa::scalar)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_WidenInt16, avx2, simd::Isa::avx2)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_NarrowBfloat16, scalar, simd::Isa::scalar)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_NarrowBfloat16, avx2, simd::Isa::avx2)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_NarrowInt16, scalar, simd::Isa::scalar)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_NarrowInt16, avx2, simd::Isa::avx2)->Apply(CompactArgs);
+
+#if SUNIT_HALF
+static void BM_WidenHalf(benchmark::State& state, simd::Isa isa) { CompactWiden<half>(state, isa); }
+static void BM_NarrowHalf(benchmark::State& state, simd::Isa isa) { CompactNarrow<half>(state, isa); }
+BENCHMARK_CAPTURE(BM_WidenHalf, scalar, simd::Isa::scalar)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_WidenHalf, avx2, simd::Isa::avx2)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_NarrowHalf, scalar, simd::Isa::scalar)->Apply(CompactArgs);
+BENCHMARK_CAPTURE(BM_NarrowHalf, avx2, simd::Isa::avx2)->Apply(CompactArgs);
+#endif
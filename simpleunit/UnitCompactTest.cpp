@@ -0,0 +1,219 @@
+#include "simpleunit/UnitCompact.h"
+#include "simpleunit/UnitFormat.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+using MetersB16 = Unit<bfloat16, Length<meter>>;
+using CentimetersB16 = Unit<bfloat16, Length<std::centi>>;
+using Millimeters16 = Unit<int16_t, Length<std::milli>>;
+
+TEST(UnitCompactTest, Bfloat16)
+{
+	EXPECT_EQ(2u, sizeof(bfloat16));
+	EXPECT_EQ(1.5f, float(bfloat16(1.5f)));
+	EXPECT_EQ(-256.f, float(bfloat16(-256.f)));
+
+	// Rounded to nearest, ties to even
+	EXPECT_EQ(1.f, float(bfloat16(1.f + 1.f / 512)));
+	EXPECT_EQ(1.f, float(bfloat16(1.f + 1.f / 256)));
+	EXPECT_EQ(1.f + 1.f / 64, float(bfloat16(1.f + 3.f / 256)));
+	EXPECT_EQ(1.f + 1.f / 128, float(bfloat16(1.f + 1.f / 128 + 1.f / 256 - 1.f / 4096)));
+	EXPECT_EQ(0x3F80, bfloat16(1.f).bits());
+
+	EXPECT_TRUE(std::isinf(float(bfloat16(numeric_limits<float>::infinity()))));
+	EXPECT_TRUE(std::isinf(float(bfloat16(numeric_limits<float>::max()))));
+	EXPECT_TRUE(std::isnan(float(bfloat16(numeric_limits<float>::quiet_NaN()))));
+	EXPECT_TRUE(std::isnan(float(bfloat16(numeric_limits<float>::signaling_NaN()))));
+
+	EXPECT_EQ(1.f / 128, float(numeric_limits<bfloat16>::epsilon()));
+	EXPECT_FLOAT_EQ(3.3895314e38f, float(numeric_limits<bfloat16>::max()));
+	EXPECT_EQ(-float(numeric_limits<bfloat16>::max()), float(numeric_limits<bfloat16>::lowest()));
+
+	bfloat16 b = 1.f;
+	b += 2;
+	b *= 1.5f;
+	EXPECT_EQ(4.5f, float(b));
+}
+
+TEST(UnitCompactTest, Units)
+{
+	EXPECT_EQ(2u, sizeof(MetersB16));
+	EXPECT_EQ(2u, sizeof(Millimeters16));
+
+	// Conversions multiply in float and round once
+	MetersB16 m = Centimeters(150);
+	EXPECT_EQ(1.5f, float(m.value()));
+	EXPECT_FLOAT_EQ(150.f, Centimeters(m).value());
+	EXPECT_EQ(150.f, float(unit_cast<CentimetersB16>(m).value()));
+
+	// Arithmetic is carried out in float
+	auto sum = MetersB16(1.5f) + CentimetersB16(25);
+	static_assert(is_same<decltype(sum), Unit<float, Length<std::centi>>>::value, "");
+	EXPECT_FLOAT_EQ(175.f, sum.value());
+
+	auto area = MetersB16(2) * MetersB16(3);
+	static_assert(is_same<decltype(area)::rep, float>::value, "");
+	EXPECT_FLOAT_EQ(6.f, area.value());
+
+	auto scaled = MetersB16(2) * 3;
+	static_assert(is_same<decltype(scaled), Unit<float, Length<meter>>>::value, "");
+	EXPECT_FLOAT_EQ(6.f, scaled.value());
+
+	MetersB16 acc(1.f);
+	acc += MetersB16(0.5f);
+	EXPECT_EQ(1.5f, float(acc.value()));
+
+	// Fixed-point, with the scale in the type. A cast truncates, as for other integral reps.
+	Millimeters16 mm = unit_cast<Millimeters16>(Millimeters(1234.5f));
+	EXPECT_EQ(1234, mm.value());
+	EXPECT_FLOAT_EQ(1.234f, Meters(mm).value());
+	EXPECT_EQ(32767, (unit_cast<Millimeters16>(Meters(40), saturate).value()));
+
+	// Formatted in their compute type
+	ostringstream os;
+	os << MetersB16(1.5f) << ", " << Millimeters16(12);
+	EXPECT_EQ("1.5 m, 12 mm", os.str());
+}
+
+#if SUNIT_HALF
+namespace
+{
+	// On x86, half needs F16C (the simpleunit_f16c build), which the CPU running it may lack
+	bool half_supported()
+	{
+#if SUNIT_SIMD_X86
+		return __builtin_cpu_supports("f16c");
+#else
+		return true;
+#endif
+	}
+}
+
+TEST(UnitCompactTest, Half)
+{
+	if (!half_supported())
+		GTEST_SKIP() << "the CPU has no F16C";
+
+	using MetersF16 = Unit<half, Length<meter>>;
+
+	EXPECT_EQ(2u, sizeof(MetersF16));
+	MetersF16 m = Centimeters(150);
+	EXPECT_EQ(1.5f, float(m.value()));
+	EXPECT_FLOAT_EQ(1.5f, Meters(m).value());
+
+	auto sum = m + Centimeters(25);
+	static_assert(is_same<decltype(sum)::rep, float>::value, "");
+	EXPECT_FLOAT_EQ(175.f, sum.value());
+}
+#endif
+
+namespace
+{
+	vector<float> samples(size_t n)
+	{
+		vector<float> v(n);
+		for (size_t i = 0; i < n; ++i)
+			v[i] = (i % 7 == 0 ? -1.f : 1.f) * (0.37f * i + 0.001f * i * i);
+		return v;
+	}
+
+	template <typename S>
+	void check_kernels(float scale)
+	{
+		for (auto isa : { simd::Isa::scalar, simd::Isa::sse2, simd::Isa::avx2, simd::Isa::avx512 }) {
+			for (size_t n : { 0, 1, 7, 8, 15, 16, 17, 33, 100 }) {
+				vector<float> in = samples(n);
+				if (n > 3) {
+					in[1] = numeric_limits<float>::quiet_NaN();
+					in[2] = 1e30f;
+					in[3] = -1e30f;
+				}
+
+				vector<S> expected(n), out(n);
+				simd::narrow(in.data(), expected.data(), n, scale, simd::Isa::scalar);
+				simd::narrow(in.data(), out.data(), n, scale, isa);
+				vector<float> wide(n), wide_expected(n);
+				simd::widen(expected.data(), wide_expected.data(), n, 1 / scale, simd::Isa::scalar);
+				simd::widen(expected.data(), wide.data(), n, 1 / scale, isa);
+				for (size_t i = 0; i < n; ++i) {
+					if (std::isnan(wide_expected[i])) {
+						EXPECT_TRUE(std::isnan(wide[i])) << simd::name(isa) << " n=" << n << " i=" << i;
+						continue;
+					}
+					EXPECT_EQ(wide_expected[i], wide[i]) << simd::name(isa) << " n=" << n << " i=" << i;
+					EXPECT_EQ(float(expected[i]), float(out[i])) << simd::name(isa) << " n=" << n << " i=" << i;
+				}
+			}
+		}
+	}
+}
+
+TEST(UnitCompactTest, Kernels)
+{
+	// Every kernel agrees with the scalar loop, including tails, NaN and overflow. One the CPU
+	// doesn't support is the scalar loop.
+	check_kernels<bfloat16>(100.f);
+	check_kernels<int16_t>(100.f);
+#if SUNIT_HALF
+	if (half_supported())
+		check_kernels<half>(1.f);
+#endif
+
+	// int16 rounds to nearest, ties to even, and saturates
+	const float in[] = { 1.5f, 2.5f, -1.5f, -0.4f, 1e9f, -1e9f, 32767.4f, -32768.6f };
+	int16_t out[8];
+	for (auto isa : { simd::Isa::scalar, simd::Isa::avx2 }) {
+		if (!simd::supported(isa))
+			continue;
+		vector<float> padded(in, in + 8);
+		padded.resize(16, 0.f);
+		int16_t wide_out[16];
+		simd::narrow(padded.data(), wide_out, 16, 1.f, isa);
+		std::copy(wide_out, wide_out + 8, out);
+		EXPECT_EQ(2, out[0]);
+		EXPECT_EQ(2, out[1]);
+		EXPECT_EQ(-2, out[2]);
+		EXPECT_EQ(0, out[3]);
+		EXPECT_EQ(32767, out[4]);
+		EXPECT_EQ(-32768, out[5]);
+		EXPECT_EQ(32767, out[6]);
+		EXPECT_EQ(-32768, out[7]);
+	}
+}
+
+TEST(UnitCompactTest, WidenNarrow)
+{
+	const vector<float> cm = samples(100);
+	const auto in = unit_span<Centimeters>(cm.data(), cm.size());
+
+	// bfloat16 keeps 8 bits of precision
+	UnitArray<bfloat16, Length<meter>> b(cm.size());
+	narrow(in, b.span());
+	ArrayOf<Centimeters> back(cm.size());
+	widen(b.span(), back.span());
+	for (size_t i = 0; i < cm.size(); ++i) {
+		EXPECT_NEAR(cm[i], back[i].value(), std::abs(cm[i]) / 256 + 1e-6f) << i;
+		EXPECT_EQ(float(bfloat16(cm[i] * 0.01f)), float(b[i].value())) << i;
+	}
+
+	// int16 millimeters lose at most half a millimeter, within range
+	UnitArray<int16_t, Length<std::milli>> mm(cm.size());
+	narrow(in, mm.span());
+	widen(mm.span(), back.span());
+	for (size_t i = 0; i < cm.size(); ++i)
+		EXPECT_NEAR(cm[i], back[i].value(), 0.05f + std::abs(cm[i]) * 1e-6f) << i;
+
+	// Meters widen to a float span of another unit
+	ArrayOf<Millimeters> wide(cm.size());
+	widen(ConstSpanOf<Unit<bfloat16, Length<meter>>>(b.span()), wide.span());
+	EXPECT_FLOAT_EQ(float(b[10].value()) * 1000, wide[10].value());
+
+	//widen(b.span(), ArrayOf<Seconds>(cm.size()).span());  // Should not compile: widen converts between units of equal dimensions
+}
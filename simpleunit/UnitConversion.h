@@ -0,0 +1,171 @@
+#ifndef SIMPLEUNIT_UNITCONVERSION_H
+#define SIMPLEUNIT_UNITCONVERSION_H
+
+#include "simpleunit/Unit.h"
+#include "simpleunit/UnitScale.h"
+#include "simpleunit/UnitSimd.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sunit {
+
+// Conversions between units known only at runtime, such as columns described by a file.
+//
+// A `UnitSignature` is a unit's dimensions and scale. A `ConversionTable` works out the
+// conversion between two signatures once and caches it in a flat open-addressing table.
+// Lookups are lock-free and safe alongside other lookups and insertions. Insertions are
+// serialized by a mutex. Bulk conversions look up their factor once, then convert every value.
+//
+//     const UnitSignature from{ Dim<1>::code, Scale{ 1, 100 } };        // cm
+//     sunit::convert(in, out, n, from, signature_of<si::Meters::base>());
+
+struct UnitSignature {
+	DimCode dim;
+	Scale scale;
+};
+
+constexpr bool operator==(const UnitSignature& lhs, const UnitSignature& rhs) { return lhs.dim == rhs.dim && lhs.scale == rhs.scale; }
+constexpr bool operator!=(const UnitSignature& lhs, const UnitSignature& rhs) { return !(lhs == rhs); }
+
+template <typename B>
+constexpr UnitSignature signature_of() { return UnitSignature{ B::dim::code, scale_of_base<B>() }; }
+
+// The conversion from one unit to another of the same dimensions, exactly and as a double
+struct Conversion {
+	Scale scale;
+	double factor;
+};
+
+// The conversion from `from` to `to`, throwing std::invalid_argument if their dimensions
+// differ and std::overflow_error if the ratio doesn't fit a Scale
+inline Conversion make_conversion(const UnitSignature& from, const UnitSignature& to)
+{
+	if (from.dim != to.dim)
+		throw std::invalid_argument("sunit: can't convert between units of different dimensions");
+	const Scale s = scale_divide(from.scale, to.scale);
+	return Conversion{ s, static_cast<double>(static_cast<long double>(s.num) / s.den) };
+}
+
+class ConversionTable
+{
+public:
+	// A table of at least capacity slots, holding up to half as many conversions
+	explicit ConversionTable(std::size_t capacity = 1024)
+		: mask_(slot_count(capacity) - 1), slots_(new Slot[mask_ + 1]) {}
+
+	ConversionTable(const ConversionTable&) = delete;
+	ConversionTable& operator=(const ConversionTable&) = delete;
+
+	// The cached conversion, or nullptr if there is none yet. Lock-free.
+	const Conversion* find(const UnitSignature& from, const UnitSignature& to) const {
+		for (std::size_t i = hash(from, to) & mask_; ; i = (i + 1) & mask_) {
+			const Slot& slot = slots_[i];
+			if (!slot.ready.load(std::memory_order_acquire))
+				return nullptr;
+			if (slot.from == from && slot.to == to)
+				return &slot.conversion;
+		}
+	}
+
+	// The conversion from `from` to `to`, working it out and caching it on first use. Once
+	// the table is half full, further conversions are worked out on each call.
+	Conversion get(const UnitSignature& from, const UnitSignature& to) {
+		if (const Conversion* c = find(from, to))
+			return *c;
+		const Conversion c = make_conversion(from, to);
+
+		std::lock_guard<std::mutex> lock(insert_);
+		if (2 * (size_.load(std::memory_order_relaxed) + 1) > mask_ + 1)
+			return c;
+		std::size_t i = hash(from, to) & mask_;
+		for (; slots_[i].ready.load(std::memory_order_relaxed); i = (i + 1) & mask_)
+			if (slots_[i].from == from && slots_[i].to == to)
+				return slots_[i].conversion;
+		Slot& slot = slots_[i];
+		slot.from = from;
+		slot.to = to;
+		slot.conversion = c;
+		slot.ready.store(true, std::memory_order_release);
+		size_.fetch_add(1, std::memory_order_relaxed);
+		return c;
+	}
+
+	// The number of cached conversions
+	std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+	// Written once, before `ready` is set, and never again
+	struct Slot {
+		std::atomic<bool> ready{ false };
+		UnitSignature from;
+		UnitSignature to;
+		Conversion conversion;
+	};
+
+	static std::size_t slot_count(std::size_t capacity) {
+		std::size_t n = 2;
+		while (n < capacity)
+			n *= 2;
+		return n;
+	}
+
+	static std::uint64_t mix(std::uint64_t h, std::uint64_t x) {
+		h ^= x + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+		return h;
+	}
+
+	static std::size_t hash(const UnitSignature& from, const UnitSignature& to) {
+		std::uint64_t h = static_cast<std::uint64_t>(from.dim) << 32 | to.dim;
+		h = mix(h, static_cast<std::uint64_t>(from.scale.num));
+		h = mix(h, static_cast<std::uint64_t>(from.scale.den));
+		h = mix(h, static_cast<std::uint64_t>(to.scale.num));
+		h = mix(h, static_cast<std::uint64_t>(to.scale.den));
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		return static_cast<std::size_t>(h);
+	}
+
+	std::size_t mask_;
+	std::unique_ptr<Slot[]> slots_;
+	std::atomic<std::size_t> size_{ 0 };
+	std::mutex insert_;
+};
+
+// The table shared by conversions that don't pass their own
+inline ConversionTable& conversions()
+{
+	static ConversionTable table;
+	return table;
+}
+
+// out[i] = in[i] converted by scale s, as unit_cast would convert a single value
+template <typename Y, typename X>
+void convert_values(const X* in, Y* out, std::size_t n, Scale s)
+{
+	if constexpr (std::is_floating_point<Y>::value && std::is_same<X, Y>::value) {
+		simd::scale(in, out, n, static_cast<Y>(static_cast<long double>(s.num) / s.den));
+	}
+	else {
+		for (std::size_t i = 0; i < n; ++i)
+			out[i] = scale_value<Y>(in[i], s);
+	}
+}
+
+// Convert n values from unit `from` to unit `to`, with one lookup in table
+template <typename Y, typename X>
+void convert(const X* in, Y* out, std::size_t n, const UnitSignature& from, const UnitSignature& to,
+             ConversionTable& table = conversions())
+{
+	convert_values(in, out, n, table.get(from, to).scale);
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITCONVERSION_H
@@ -0,0 +1,68 @@
+#include "simpleunit/UnitConversion.h"
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Converting many short columns between units known at runtime: working out each conversion
+// from the ratios of each lane, against looking it up in a ConversionTable
+
+namespace
+{
+	constexpr size_t columns = 64;
+	constexpr size_t rows = 256;
+
+	// in/hr, from the ratios of each lane
+	const std::int64_t ratios[dim_count][2] = { { 1, 39 }, { 3600, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 } };
+	constexpr DimCode dim = Dim<1,-1>::code;
+
+	Scale lane_scale()
+	{
+		Scale s{ 1, 1 };
+		for (std::size_t i = 0; i < dim_count; ++i)
+			s = scale_multiply(s, scale_pow(Scale{ ratios[i][0], ratios[i][1] }, dim_exponent(dim, i)));
+		return s;
+	}
+}
+
+static void BM_ConversionCompute(benchmark::State& state)
+{
+	std::vector<float> in(rows, 1.f), out(rows);
+	for (auto _ : state) {
+		for (size_t c = 0; c < columns; ++c) {
+			const UnitSignature from{ dim, lane_scale() };
+			const Conversion conversion = make_conversion(from, signature_of<m_s::base>());
+			convert_values(in.data(), out.data(), rows, conversion.scale);
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * columns * rows);
+}
+BENCHMARK(BM_ConversionCompute);
+
+static void BM_ConversionLookup(benchmark::State& state)
+{
+	std::vector<float> in(rows, 1.f), out(rows);
+	const UnitSignature from{ dim, lane_scale() };
+	for (auto _ : state) {
+		for (size_t c = 0; c < columns; ++c)
+			convert(in.data(), out.data(), rows, from, signature_of<m_s::base>());
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * columns * rows);
+}
+BENCHMARK(BM_ConversionLookup);
+
+static void BM_ConversionFind(benchmark::State& state)
+{
+	ConversionTable table;
+	for (std::int64_t i = 1; i <= 256; ++i)
+		table.get(UnitSignature{ Dim<1>::code, Scale{ 1, i } }, signature_of<Meters::base>());
+	std::int64_t i = 0;
+	for (auto _ : state) {
+		i = i % 256 + 1;
+		benchmark::DoNotOptimize(table.find(UnitSignature{ Dim<1>::code, Scale{ 1, i } }, signature_of<Meters::base>()));
+	}
+}
+BENCHMARK(BM_ConversionFind);
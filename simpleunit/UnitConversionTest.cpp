@@ -0,0 +1,105 @@
+#include "simpleunit/UnitConversion.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	const UnitSignature centimeters{ Dim<1>::code, Scale{ 1, 100 } };
+	const UnitSignature meters = signature_of<Meters::base>();
+	const UnitSignature inches = signature_of<Inches::base>();
+	const UnitSignature seconds = signature_of<Seconds::base>();
+
+	UnitSignature length(int64_t den) { return UnitSignature{ Dim<1>::code, Scale{ 1, den } }; }
+}
+
+TEST(UnitConversionTest, Signatures)
+{
+	static_assert(signature_of<Centimeters2::base>() == UnitSignature{ Dim<2>::code, Scale{ 1, 10000 } }, "");
+	static_assert(signature_of<in_hr::base>() == UnitSignature{ (Dim<1,-1>::code), Scale{ 1, 39 * 3600 } }, "");
+	static_assert(signature_of<Meters::base>() != signature_of<Seconds::base>(), "");
+
+	const Conversion c = make_conversion(centimeters, inches);
+	EXPECT_EQ((Scale{ 39, 100 }), c.scale);
+	EXPECT_DOUBLE_EQ(0.39, c.factor);
+	EXPECT_THROW(make_conversion(meters, seconds), std::invalid_argument);
+}
+
+TEST(UnitConversionTest, Table)
+{
+	ConversionTable table(16);
+	EXPECT_EQ(nullptr, table.find(centimeters, meters));
+
+	const Conversion c = table.get(centimeters, meters);
+	EXPECT_EQ((Scale{ 1, 100 }), c.scale);
+	EXPECT_EQ(1u, table.size());
+
+	const Conversion* found = table.find(centimeters, meters);
+	ASSERT_NE(nullptr, found);
+	EXPECT_EQ(c.scale, found->scale);
+	EXPECT_EQ(found, table.find(centimeters, meters));
+
+	// Each direction is its own entry
+	EXPECT_EQ(nullptr, table.find(meters, centimeters));
+	EXPECT_EQ((Scale{ 100, 1 }), table.get(meters, centimeters).scale);
+	EXPECT_EQ(2u, table.size());
+
+	EXPECT_THROW(table.get(meters, seconds), std::invalid_argument);
+	EXPECT_EQ(2u, table.size());
+}
+
+TEST(UnitConversionTest, Full)
+{
+	// Half of 16 slots are used; conversions beyond that are still correct, but not cached
+	ConversionTable table(16);
+	for (int64_t i = 1; i <= 20; ++i)
+		EXPECT_EQ((Scale{ 1, i }), table.get(length(i), meters).scale);
+	EXPECT_EQ(8u, table.size());
+	for (int64_t i = 1; i <= 8; ++i)
+		EXPECT_NE(nullptr, table.find(length(i), meters));
+	EXPECT_EQ(nullptr, table.find(length(20), meters));
+}
+
+TEST(UnitConversionTest, Concurrent)
+{
+	ConversionTable table(256);
+	atomic<int> wrong{ 0 };
+	vector<thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&] {
+			for (int round = 0; round < 100; ++round)
+				for (int64_t i = 1; i <= 64; ++i)
+					if (table.get(length(i), meters).scale != Scale{ 1, i })
+						++wrong;
+		});
+	}
+	for (thread& t : threads)
+		t.join();
+	EXPECT_EQ(0, wrong.load());
+	EXPECT_EQ(64u, table.size());
+}
+
+TEST(UnitConversionTest, Convert)
+{
+	const float cm[] = { 150.f, -20.f, 0.5f };
+	float m[3];
+	convert(cm, m, 3, centimeters, meters);
+	EXPECT_FLOAT_EQ(1.5f, m[0]);
+	EXPECT_FLOAT_EQ(-0.2f, m[1]);
+	EXPECT_FLOAT_EQ(0.005f, m[2]);
+	EXPECT_NE(nullptr, conversions().find(centimeters, meters));
+
+	const int mm[] = { 2999, 3000 };
+	int whole[2];
+	convert(mm, whole, 2, length(1000), meters);
+	EXPECT_EQ(2, whole[0]);
+	EXPECT_EQ(3, whole[1]);
+
+	EXPECT_THROW(convert(cm, m, 3, centimeters, seconds), std::invalid_argument);
+}
@@ -0,0 +1,255 @@
+#ifndef SIMPLEUNIT_UNITDEFERRED_H
+#define SIMPLEUNIT_UNITDEFERRED_H
+
+#include "simpleunit/Unit.h"
+
+#include <functional>
+#include <ratio>
+#include <type_traits>
+
+namespace sunit {
+
+// Scalar expressions with a deferred scale.
+//
+// Each binary Unit operator rescales both operands to their CommonBase before it operates,
+// so a chain like `a * b / c` with mixed scales pays for several conversions. A `Deferred`
+// quantity instead carries its whole scale as a single compile-time ratio S alongside the
+// raw coefficient: products and quotients multiply and divide the coefficients and fold
+// the ratios at compile time. The value is normalised once, with a single rescale (or none
+// where the ratios cancel), when it's converted to a concrete Unit.
+//
+// Sums and differences keep their terms deferred as a `DeferredSum`, and each term is
+// rescaled straight to the Unit the sum converts to, so `a * b / c + d` converted to the
+// unit of d rescales once. A sum that is multiplied or divided is first added up at the
+// common scale of its terms.
+//
+//     Meters_Second v = deferred(width) * height / time;
+
+// The magnitude of base B with respect to unit ratios: the product of each r^d
+template <typename B, typename D = typename B::dim>
+using BaseScale = BaseConversion<B, BaseUnit<D>, D>;
+
+template <typename T, typename D, typename S>
+class Deferred;
+
+template <typename Op, typename L, typename R>
+class DeferredSum;
+
+namespace detail
+{
+	template <typename S1, typename S2>
+	using CommonScale = CommonRatio<S1, S2>;
+
+	// A conversion to an integral rep must not lose information, as for Unit's constructors
+	template <typename X, typename R>
+	using IsLosslessRescale = std::integral_constant<bool, treat_as_floating_point<X>::value || R::den == 1>;
+
+	template <typename E>
+	struct IsDeferred : std::false_type {};
+
+	template <typename T, typename D, typename S>
+	struct IsDeferred<Deferred<T,D,S>> : std::true_type {};
+
+	template <typename Op, typename L, typename R>
+	struct IsDeferred<DeferredSum<Op,L,R>> : std::true_type {};
+
+	template <typename E>
+	struct IsDeferredSum : std::false_type {};
+
+	template <typename Op, typename L, typename R>
+	struct IsDeferredSum<DeferredSum<Op,L,R>> : std::true_type {};
+
+	// The Deferred a sum is multiplied as: its terms added up at their common scale
+	template <typename T, typename D, typename S>
+	constexpr const Deferred<T,D,S>& added(const Deferred<T,D,S>& e) { return e; }
+
+	template <typename Op, typename L, typename R>
+	constexpr auto added(const DeferredSum<Op,L,R>& e) { return e.sum(); }
+}
+
+template <typename T, typename D, typename S>
+class Deferred
+{
+public:
+	using rep = T;
+	using dim = D;
+	using scale = S;
+
+	explicit constexpr Deferred(const T& val) : value_(val) {}
+
+	template <typename X, typename B>
+	explicit constexpr Deferred(const Unit<X,B>& unit) : value_(unit.value()) {
+		static_assert(B::dim::code == D::code, "Deferred dimensions must match the unit's");
+		static_assert(std::is_same<S, BaseScale<B>>::value, "Deferred scale must match the unit's base");
+	}
+
+	constexpr const T& value() const { return value_; }
+
+	// The coefficient as a Y at scale S2, with one rescale (or none where the scales match)
+	template <typename Y, typename S2>
+	constexpr Y at() const { return rescale<Y, std::ratio_divide<S,S2>>(value_); }
+
+	// Normalise to a concrete Unit, with at most one rescale
+	template <typename Q>
+	constexpr Q as() const {
+		using B = typename Q::base;
+		static_assert(B::dim::code == D::code, "Dimensions must agree");
+		return Q(at<typename Q::rep, BaseScale<B>>());
+	}
+
+	template <typename X, typename B,
+		typename std::enable_if_t<detail::IsLosslessRescale<X, std::ratio_divide<S, BaseScale<B>>>::value, int> = 0>
+	constexpr operator Unit<X,B>() const { return as<Unit<X,B>>(); }
+
+private:
+	T value_;
+};
+
+// The sum or difference (Op) of two deferred terms of equal dimensions, each still at its own scale
+template <typename Op, typename L, typename R>
+class DeferredSum
+{
+public:
+	using rep = AddType<typename L::rep, typename R::rep>;
+	using dim = DimAdd<typename L::dim, typename R::dim>;
+	using scale = detail::CommonScale<typename L::scale, typename R::scale>;
+
+	constexpr DeferredSum(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {}
+
+	// The terms added up as a Y at scale S2, rescaling each term straight there
+	template <typename Y, typename S2>
+	constexpr Y at() const { return Op()(lhs_.template at<Y,S2>(), rhs_.template at<Y,S2>()); }
+
+	// The sum at the common scale, where integral terms add exactly
+	constexpr rep value() const { return at<rep, scale>(); }
+	constexpr Deferred<rep,dim,scale> sum() const { return Deferred<rep,dim,scale>(value()); }
+
+	// Normalise to a concrete Unit. Each term is rescaled to it once, unless that would round
+	// integral terms apart; those are added up at the common scale and rescaled once after.
+	template <typename Q>
+	constexpr Q as() const {
+		using B = typename Q::base;
+		using Y = typename Q::rep;
+		static_assert(B::dim::code == dim::code, "Dimensions must agree");
+		if constexpr (detail::IsLosslessRescale<Y, std::ratio_divide<scale, BaseScale<B>>>::value)
+			return Q(at<Y, BaseScale<B>>());
+		else
+			return Q(rescale<Y, std::ratio_divide<scale, BaseScale<B>>>(value()));
+	}
+
+	template <typename X, typename B,
+		typename std::enable_if_t<detail::IsLosslessRescale<X, std::ratio_divide<scale, BaseScale<B>>>::value, int> = 0>
+	constexpr operator Unit<X,B>() const { return as<Unit<X,B>>(); }
+
+private:
+	L lhs_;
+	R rhs_;
+};
+
+template <typename X, typename B>
+constexpr Deferred<X, typename B::dim, BaseScale<B>> deferred(const Unit<X,B>& unit)
+{
+	return Deferred<X, typename B::dim, BaseScale<B>>(unit);
+}
+
+// Deferred * / Deferred: the coefficients combine and the scales fold at compile time
+
+template <typename X, typename Y, typename D1, typename D2, typename S1, typename S2>
+constexpr Deferred<MulType<X,Y>, DimMultiply<D1,D2>, std::ratio_multiply<S1,S2>>
+operator*(const Deferred<X,D1,S1>& lhs, const Deferred<Y,D2,S2>& rhs)
+{
+	return Deferred<MulType<X,Y>, DimMultiply<D1,D2>, std::ratio_multiply<S1,S2>>(lhs.value() * rhs.value());
+}
+
+template <typename X, typename Y, typename D1, typename D2, typename S1, typename S2>
+constexpr Deferred<MulType<X,Y>, DimDivide<D1,D2>, std::ratio_divide<S1,S2>>
+operator/(const Deferred<X,D1,S1>& lhs, const Deferred<Y,D2,S2>& rhs)
+{
+	return Deferred<MulType<X,Y>, DimDivide<D1,D2>, std::ratio_divide<S1,S2>>(lhs.value() / rhs.value());
+}
+
+// Deferred * / a sum of them: the sum is added up first
+
+template <typename L, typename R,
+          typename = std::enable_if_t<detail::IsDeferred<L>::value && detail::IsDeferred<R>::value &&
+                                      (detail::IsDeferredSum<L>::value || detail::IsDeferredSum<R>::value)>>
+constexpr auto operator*(const L& lhs, const R& rhs) { return detail::added(lhs) * detail::added(rhs); }
+
+template <typename L, typename R,
+          typename = std::enable_if_t<detail::IsDeferred<L>::value && detail::IsDeferred<R>::value &&
+                                      (detail::IsDeferredSum<L>::value || detail::IsDeferredSum<R>::value)>>
+constexpr auto operator/(const L& lhs, const R& rhs) { return detail::added(lhs) / detail::added(rhs); }
+
+// Deferred + - Deferred, or sums of them: equal dimensions, with the terms kept apart
+
+template <typename L, typename R,
+          typename = std::enable_if_t<detail::IsDeferred<L>::value && detail::IsDeferred<R>::value>>
+constexpr DeferredSum<std::plus<>, L, R> operator+(const L& lhs, const R& rhs)
+{
+	return DeferredSum<std::plus<>, L, R>(lhs, rhs);
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<detail::IsDeferred<L>::value && detail::IsDeferred<R>::value>>
+constexpr DeferredSum<std::minus<>, L, R> operator-(const L& lhs, const R& rhs)
+{
+	return DeferredSum<std::minus<>, L, R>(lhs, rhs);
+}
+
+// Deferred + - * / Unit, in either order
+
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator*(const E& lhs, const Unit<Y,B>& rhs) { return lhs * deferred(rhs); }
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator*(const Unit<Y,B>& lhs, const E& rhs) { return deferred(lhs) * rhs; }
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator/(const E& lhs, const Unit<Y,B>& rhs) { return lhs / deferred(rhs); }
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator/(const Unit<Y,B>& lhs, const E& rhs) { return deferred(lhs) / rhs; }
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator+(const E& lhs, const Unit<Y,B>& rhs) { return lhs + deferred(rhs); }
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator+(const Unit<Y,B>& lhs, const E& rhs) { return deferred(lhs) + rhs; }
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator-(const E& lhs, const Unit<Y,B>& rhs) { return lhs - deferred(rhs); }
+template <typename E, typename Y, typename B, typename = std::enable_if_t<detail::IsDeferred<E>::value>>
+constexpr auto operator-(const Unit<Y,B>& lhs, const E& rhs) { return deferred(lhs) - rhs; }
+
+// Scalar * / Deferred
+
+template <typename X, typename D, typename S, typename Y,
+          typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
+constexpr Deferred<MulType<X,Y>,D,S> operator*(const Deferred<X,D,S>& lhs, const Y& y)
+{
+	return Deferred<MulType<X,Y>,D,S>(lhs.value() * y);
+}
+
+template <typename X, typename D, typename S, typename Y,
+          typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
+constexpr Deferred<MulType<X,Y>,D,S> operator*(const Y& y, const Deferred<X,D,S>& rhs)
+{
+	return Deferred<MulType<X,Y>,D,S>(rhs.value() * y);
+}
+
+template <typename X, typename D, typename S, typename Y,
+          typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
+constexpr Deferred<MulType<X,Y>,D,S> operator/(const Deferred<X,D,S>& lhs, const Y& y)
+{
+	return Deferred<MulType<X,Y>,D,S>(lhs.value() / y);
+}
+
+template <typename E, typename Y,
+          typename std::enable_if_t<detail::IsDeferredSum<E>::value && std::is_arithmetic<Y>::value, int> = 0>
+constexpr auto operator*(const E& lhs, const Y& y) { return lhs.sum() * y; }
+
+template <typename E, typename Y,
+          typename std::enable_if_t<detail::IsDeferredSum<E>::value && std::is_arithmetic<Y>::value, int> = 0>
+constexpr auto operator*(const Y& y, const E& rhs) { return y * rhs.sum(); }
+
+template <typename E, typename Y,
+          typename std::enable_if_t<detail::IsDeferredSum<E>::value && std::is_arithmetic<Y>::value, int> = 0>
+constexpr auto operator/(const E& lhs, const Y& y) { return lhs.sum() / y; }
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITDEFERRED_H
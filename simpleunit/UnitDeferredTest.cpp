@@ -0,0 +1,125 @@
+#include "simpleunit/UnitDeferred.h"
+#include <type_traits>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	// A floating-point rep counting its multiplications, one for each rescale or product
+	struct Counted
+	{
+		static inline int multiplies = 0;
+		double v;
+
+		Counted(double x = 0) : v(x) {}
+		friend Counted operator*(Counted a, Counted b) { ++multiplies; return a.v * b.v; }
+		friend Counted operator/(Counted a, Counted b) { return a.v / b.v; }
+		friend Counted operator+(Counted a, Counted b) { return a.v + b.v; }
+		friend Counted operator-(Counted a, Counted b) { return a.v - b.v; }
+	};
+}
+
+namespace sunit
+{
+	template <>
+	struct treat_as_floating_point<Counted> : std::true_type {};
+}
+
+TEST(UnitDeferredTest, BaseScale)
+{
+	static_assert(is_same<BaseScale<Meters::base>, ratio<1>>::value, "");
+	static_assert(is_same<BaseScale<Centimeters2::base>, ratio<1,10000>>::value, "");
+	static_assert(is_same<BaseScale<Inches_Hour::base>, ratio<1,39*3600>>::value, "");
+	static_assert(is_same<BaseScale<Minutes::base>, ratio<60>>::value, "");
+}
+
+TEST(UnitDeferredTest, ScaleFolding)
+{
+	constexpr Centimeters width(200);
+	constexpr Millimeters height(5000);
+	constexpr Minutes time(2.2f);
+
+	// The scales fold into one compile-time ratio, with no conversion so far
+	constexpr auto e = deferred(width) * height / time;
+	using E = decltype(e);
+	static_assert(is_same<E::scale, ratio<1, 100 * 1000 * 60>>::value, "");
+	static_assert(is_same<E::dim, Meters2_Second::base::dim>::value, "");
+	EXPECT_FLOAT_EQ(200.f * 5000.f / 2.2f, e.value());
+
+	// and normalise with a single multiply
+	static_assert(rescale_kind<float, ratio_divide<E::scale, BaseScale<Meters2_Second::base>>>() == RescaleKind::scale, "");
+	constexpr Meters2_Second flowrate = e;
+	EXPECT_FLOAT_EQ(0.0757575757f, flowrate.value());
+	EXPECT_FLOAT_EQ((width * height / time).asVal<Meters2_Second>(), flowrate.value());
+
+	// or none at all, where the scales cancel
+	auto ratio_ = deferred(Centimeters(50)) * Seconds(3) / Centimeters(10);
+	static_assert(is_same<decltype(ratio_)::scale, ratio<1>>::value, "");
+	Seconds s = ratio_;
+	EXPECT_FLOAT_EQ(15.f, s.value());
+}
+
+TEST(UnitDeferredTest, Addition)
+{
+	// a * b / c + d, added up at the product's finer scale
+	auto e = deferred(Centimeters(200)) * Meters(5) / Seconds(100) + Meters2_Second(1);
+	static_assert(is_same<decltype(e)::scale, ratio<1,100>>::value, "");
+	EXPECT_FLOAT_EQ(1.1f, e.as<Meters2_Second>().value());
+
+	// Integral addition is exact at the finer common scale
+	auto i = deferred(Unit<int, Length<meter>>(1)) + Unit<int, Length<std::centi>>(5);
+	static_assert(is_same<decltype(i)::scale, std::centi>::value, "");
+	EXPECT_EQ(105, i.value());
+	Unit<int, Length<std::milli>> mm = i;
+	EXPECT_EQ(1050, mm.value());
+
+	auto d = Meters(2) - deferred(Centimeters(50));
+	EXPECT_FLOAT_EQ(1.5f, d.as<Meters>().value());
+}
+
+TEST(UnitDeferredTest, RescaleCount)
+{
+	using Flow = Unit<Counted, Meters2_Second::base>;
+	const Unit<Counted, Centimeters::base> width(200);
+	const Unit<Counted, Meters::base> height(5);
+	const Unit<Counted, Seconds::base> time(100);
+
+	// a * b / c + d: one multiply for the product and one rescale of it into the unit of d
+	Counted::multiplies = 0;
+	Flow flow = deferred(width) * height / time + Flow(1);
+	EXPECT_EQ(2, Counted::multiplies);
+	EXPECT_DOUBLE_EQ(1.1, flow.value().v);
+
+	// Each term rescales straight to the result, once, unless it's already at its scale
+	Counted::multiplies = 0;
+	Unit<Counted, Millimeters::base> mm = deferred(width) + height - Unit<Counted, Millimeters::base>(1000);
+	EXPECT_EQ(2, Counted::multiplies);
+	EXPECT_DOUBLE_EQ(6000, mm.value().v);
+
+	// Integral terms that would round apart add up at their common scale first
+	using Cm = Unit<int, Length<std::centi>>;
+	EXPECT_EQ(1, ((deferred(Cm(50)) + Cm(50)).as<Unit<int, Length<meter>>>().value()));
+
+	// A sum multiplied is added up first
+	auto area = (deferred(Meters(1)) + Centimeters(50)) * Meters(2);
+	EXPECT_FLOAT_EQ(3.f, area.as<Meters2>().value());
+	EXPECT_FLOAT_EQ(300.f, ((deferred(Meters(1)) + Centimeters(50)) * 2.f).as<Centimeters>().value());
+}
+
+TEST(UnitDeferredTest, Conversions)
+{
+	auto e = deferred(Unit<int, Length<meter>>(3)) * 2;
+	static_assert(is_convertible<decltype(e), Unit<int, Length<std::centi>>>::value, "");
+	// Narrowing to a coarser integral unit requires an explicit as<>()
+	static_assert(!is_convertible<decltype(e), Unit<int, Length<std::kilo>>>::value, "");
+	EXPECT_EQ(0, (e.as<Unit<int, Length<std::kilo>>>().value()));
+	EXPECT_EQ(600, (Unit<int, Length<std::centi>>(e).value()));
+
+	// Dividing identical dimensions leaves a dimensionless scale
+	auto q = deferred(Meters(1)) / Centimeters(1);
+	static_assert(is_same<decltype(q)::scale, ratio<100>>::value, "");
+	EXPECT_FLOAT_EQ(100.f, (q.as<Unit<float, BaseUnit<Dim<0>>>>().value()));
+}
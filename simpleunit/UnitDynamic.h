@@ -0,0 +1,221 @@
+#ifndef SIMPLEUNIT_UNITDYNAMIC_H
+#define SIMPLEUNIT_UNITDYNAMIC_H
+
+#include "simpleunit/Unit.h"
+#include "simpleunit/UnitScale.h"
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sunit {
+
+// Quantities whose unit is known only at runtime, such as values read from configuration or
+// passed across a plugin boundary.
+//
+// A `DynamicUnit<T>` holds a value, its packed Dim code and its exact Scale with respect to
+// unit ratios. It is trivially copyable and three words for reps of up to four bytes.
+// Arithmetic checks dimensions at runtime, throwing std::invalid_argument where they differ,
+// and std::overflow_error where an exponent leaves the range of Dim. Hot code converts back
+// to a static Unit with `to_static`, one integer compare and a conversion by the ratio of the
+// two scales, exact for integral reps as unit_cast is.
+//
+//     DynamicUnit<float> d = si::Centimeters(150);
+//     auto depth = d.to_static<si::Meters>();          // 1.5 m
+//     auto speed = d / DynamicUnit<float>(si::Seconds(2));
+//     speed.to_static<si::Meters>();                   // throws std::invalid_argument
+
+namespace detail
+{
+	// Convert v from one scale to another, as unit_cast converts: integral reps multiply and
+	// divide exactly, truncating, and throw std::overflow_error where the result doesn't fit.
+	// Floating reps multiply by the ratio in the compute type, with no reduction of the scales.
+	template <typename Y, typename X>
+	Y rescale_dynamic(const X& v, Scale from, Scale to)
+	{
+		if constexpr (treat_as_floating_point<Y>::value) {
+			using C = ComputeType<Y>;
+			if (from == to)
+				return static_cast<Y>(v);
+			return static_cast<Y>(static_cast<C>(v) * (static_cast<C>(from.num) / from.den * (static_cast<C>(to.den) / to.num)));
+		}
+		else {
+			const Scale factor = from == to ? Scale{ 1, 1 } : scale_divide(from, to);
+			if constexpr (std::is_integral<Y>::value)
+				return scale_value<Y>(v, factor, checked);
+			else
+				return scale_value<Y>(v, factor);
+		}
+	}
+
+	// The finest scale that both a and b are whole multiples of, as CommonRatio for static Units
+	inline Scale common_scale(Scale a, Scale b)
+	{
+		if (a == b)
+			return a;
+		const std::int64_t g = std::gcd(a.den, b.den);
+		std::int64_t den = 0;
+		if (__builtin_mul_overflow(a.den / g, b.den, &den))
+			throw std::overflow_error("sunit: scale overflows");
+		return Scale{ std::gcd(a.num, b.num), den };
+	}
+}
+
+template <typename T>
+class DynamicUnit
+{
+public:
+	using rep = T;
+
+	DynamicUnit() = default;
+
+	constexpr DynamicUnit(const T& value, DimCode dim, Scale scale)
+		: value_(value), dim_(dim), scale_(scale) {}
+
+	// From a static Unit, with its dimensions and scale
+	template <typename X, typename B, typename P>
+	constexpr DynamicUnit(const Unit<X,B,P>& q)
+		: value_(static_cast<T>(q.value())), dim_(B::dim::code), scale_(scale_of_base<B>()) {}
+
+	constexpr T& value() { return value_; }
+	constexpr const T& value() const { return value_; }
+	constexpr DimCode dim() const { return dim_; }
+	constexpr Scale scale() const { return scale_; }
+
+	// Whether this has the dimensions of U
+	template <typename U>
+	constexpr bool is() const { return dim_ == U::base::dim::code; }
+
+	// The value as a U, throwing std::invalid_argument if the dimensions differ
+	template <typename U>
+	U to_static() const
+	{
+		if (!is<U>())
+			throw std::invalid_argument("sunit: dynamic unit doesn't have the requested dimensions");
+		return U(detail::rescale_dynamic<typename U::rep>(value_, scale_, scale_of_base<typename U::base>()));
+	}
+
+	// The value at the given scale, with dimensions unchanged
+	DynamicUnit rescaled(Scale scale) const
+	{
+		return DynamicUnit(detail::rescale_dynamic<T>(value_, scale_, scale), dim_, scale);
+	}
+
+	DynamicUnit& operator+=(const DynamicUnit& rhs) { return *this = *this + rhs; }
+	DynamicUnit& operator-=(const DynamicUnit& rhs) { return *this = *this - rhs; }
+	template <typename X>
+	DynamicUnit& operator*=(const X& x) { value_ *= x; return *this; }
+	template <typename X>
+	DynamicUnit& operator/=(const X& x) { value_ /= x; return *this; }
+
+private:
+	T value_;
+	DimCode dim_;
+	Scale scale_;
+};
+
+namespace detail
+{
+	template <typename T>
+	void check_dimensions(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+	{
+		if (lhs.dim() != rhs.dim())
+			throw std::invalid_argument("sunit: dynamic units have different dimensions");
+	}
+}
+
+// Sums and differences are at the common scale of the two, as for static Units
+
+template <typename T>
+DynamicUnit<T> operator+(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	detail::check_dimensions(lhs, rhs);
+	if (lhs.scale() == rhs.scale())
+		return DynamicUnit<T>(lhs.value() + rhs.value(), lhs.dim(), lhs.scale());
+	const Scale scale = detail::common_scale(lhs.scale(), rhs.scale());
+	return DynamicUnit<T>(lhs.rescaled(scale).value() + rhs.rescaled(scale).value(), lhs.dim(), scale);
+}
+
+template <typename T>
+DynamicUnit<T> operator-(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	detail::check_dimensions(lhs, rhs);
+	if (lhs.scale() == rhs.scale())
+		return DynamicUnit<T>(lhs.value() - rhs.value(), lhs.dim(), lhs.scale());
+	const Scale scale = detail::common_scale(lhs.scale(), rhs.scale());
+	return DynamicUnit<T>(lhs.rescaled(scale).value() - rhs.rescaled(scale).value(), lhs.dim(), scale);
+}
+
+template <typename T>
+DynamicUnit<T> operator-(const DynamicUnit<T>& q)
+{
+	return DynamicUnit<T>(-q.value(), q.dim(), q.scale());
+}
+
+template <typename T>
+DynamicUnit<T> operator*(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	return DynamicUnit<T>(lhs.value() * rhs.value(), dim_add(lhs.dim(), rhs.dim()), scale_multiply(lhs.scale(), rhs.scale()));
+}
+
+template <typename T>
+DynamicUnit<T> operator/(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	return DynamicUnit<T>(lhs.value() / rhs.value(), dim_sub(lhs.dim(), rhs.dim()), scale_divide(lhs.scale(), rhs.scale()));
+}
+
+template <typename T, typename Y,
+          typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
+DynamicUnit<T> operator*(const DynamicUnit<T>& lhs, const Y& y)
+{
+	return DynamicUnit<T>(static_cast<T>(lhs.value() * y), lhs.dim(), lhs.scale());
+}
+
+template <typename T, typename Y,
+          typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
+DynamicUnit<T> operator*(const Y& y, const DynamicUnit<T>& rhs)
+{
+	return DynamicUnit<T>(static_cast<T>(rhs.value() * y), rhs.dim(), rhs.scale());
+}
+
+template <typename T, typename Y,
+          typename = std::enable_if_t<std::is_arithmetic<Y>::value>>
+DynamicUnit<T> operator/(const DynamicUnit<T>& lhs, const Y& y)
+{
+	return DynamicUnit<T>(static_cast<T>(lhs.value() / y), lhs.dim(), lhs.scale());
+}
+
+// Comparisons are between magnitudes at the common scale, so 1 m == 100 cm
+
+template <typename T>
+bool operator==(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	detail::check_dimensions(lhs, rhs);
+	const Scale scale = detail::common_scale(lhs.scale(), rhs.scale());
+	return lhs.rescaled(scale).value() == rhs.rescaled(scale).value();
+}
+
+template <typename T>
+bool operator!=(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+template <typename T>
+bool operator<(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	detail::check_dimensions(lhs, rhs);
+	const Scale scale = detail::common_scale(lhs.scale(), rhs.scale());
+	return lhs.rescaled(scale).value() < rhs.rescaled(scale).value();
+}
+
+template <typename T>
+bool operator>(const DynamicUnit<T>& lhs, const DynamicUnit<T>& rhs)
+{
+	return rhs < lhs;
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITDYNAMIC_H
@@ -0,0 +1,62 @@
+#include "simpleunit/UnitDynamic.h"
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Bringing values into a static unit: a unit_cast from a known unit, against to_static from
+// DynamicUnits of the same and of a different scale
+
+namespace
+{
+	constexpr size_t count = 4096;
+
+	template <typename U>
+	std::vector<DynamicUnit<float>> make_values()
+	{
+		std::vector<DynamicUnit<float>> values;
+		for (size_t i = 0; i < count; ++i)
+			values.push_back(U(float(i)));
+		return values;
+	}
+}
+
+static void BM_StaticCast(benchmark::State& state)
+{
+	std::vector<Centimeters> values(count, Centimeters(150));
+	for (auto _ : state) {
+		float total = 0.f;
+		for (const Centimeters& x : values)
+			total += unit_cast<Meters>(x).value();
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+BENCHMARK(BM_StaticCast);
+
+static void BM_DynamicToStatic(benchmark::State& state)
+{
+	const auto values = make_values<Meters>();
+	for (auto _ : state) {
+		float total = 0.f;
+		for (const DynamicUnit<float>& x : values)
+			total += x.to_static<Meters>().value();
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+BENCHMARK(BM_DynamicToStatic);
+
+static void BM_DynamicToStaticRescale(benchmark::State& state)
+{
+	const auto values = make_values<Centimeters>();
+	for (auto _ : state) {
+		float total = 0.f;
+		for (const DynamicUnit<float>& x : values)
+			total += x.to_static<Meters>().value();
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+BENCHMARK(BM_DynamicToStaticRescale);
@@ -0,0 +1,146 @@
+#include "simpleunit/UnitDynamic.h"
+#include "simpleunit/UnitParse.h"
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	using IntMillimeters = Unit<int, Length<std::milli>>;
+	using IntMeters = Unit<int, Length<meter>>;
+	using IntInches = Unit<int, Length<inch>>;
+	using IntCentimeters = Unit<int, Length<std::centi>>;
+	using Kilometers_Hour = Unit<float, Velocity<std::kilo, hour>>;
+}
+
+TEST(UnitDynamicTest, Layout)
+{
+	static_assert(is_trivially_copyable<DynamicUnit<float>>::value, "");
+	static_assert(is_standard_layout<DynamicUnit<float>>::value, "");
+	static_assert(sizeof(DynamicUnit<float>) == 3 * sizeof(std::int64_t), "");
+	static_assert(sizeof(DynamicUnit<int>) == 3 * sizeof(std::int64_t), "");
+}
+
+TEST(UnitDynamicTest, FromStatic)
+{
+	DynamicUnit<float> d = Centimeters(150);
+	EXPECT_EQ(Dim<1>::code, d.dim());
+	EXPECT_EQ((Scale{ 1, 100 }), d.scale());
+	EXPECT_FLOAT_EQ(150.f, d.value());
+
+	EXPECT_TRUE(d.is<Meters>());
+	EXPECT_FALSE(d.is<Meters2>());
+	EXPECT_FLOAT_EQ(1.5f, d.to_static<Meters>().value());
+	EXPECT_FLOAT_EQ(150.f, d.to_static<Centimeters>().value());
+	EXPECT_THROW(d.to_static<Seconds>(), std::invalid_argument);
+
+	DynamicUnit<float> v = Kilometers_Hour(36);
+	EXPECT_FLOAT_EQ(10.f, v.to_static<m_s>().value());
+	EXPECT_FLOAT_EQ(36.f, v.to_static<Kilometers_Hour>().value());
+}
+
+TEST(UnitDynamicTest, Integral)
+{
+	DynamicUnit<int> d = IntMeters(3);
+	EXPECT_EQ(3000, d.to_static<IntMillimeters>().value());
+
+	// Truncating, as for unit_cast
+	DynamicUnit<int> mm = IntMillimeters(2999);
+	EXPECT_EQ(2, mm.to_static<IntMeters>().value());
+	EXPECT_EQ(-2, DynamicUnit<int>(IntMillimeters(-2999)).to_static<IntMeters>().value());
+
+	// Sums are at the finer scale
+	DynamicUnit<int> sum = d + mm;
+	EXPECT_EQ((Scale{ 1, 1000 }), sum.scale());
+	EXPECT_EQ(5999, sum.value());
+
+	// Exact, with no double factor to round below a whole result
+	DynamicUnit<int> in = IntInches(39);
+	EXPECT_EQ(unit_cast<IntMillimeters>(IntInches(39)).value(), in.to_static<IntMillimeters>().value());
+	EXPECT_EQ(1000, in.to_static<IntMillimeters>().value());
+
+	// Inches and centimeters meet at a scale both convert to exactly
+	DynamicUnit<int> mixed = in + DynamicUnit<int>(IntCentimeters(1));
+	EXPECT_EQ((Scale{ 1, 3900 }), mixed.scale());
+	EXPECT_EQ(3939, mixed.value());
+	EXPECT_TRUE(in == DynamicUnit<int>(IntCentimeters(100)));
+	EXPECT_TRUE(DynamicUnit<int>(IntCentimeters(99)) < in);
+}
+
+TEST(UnitDynamicTest, IntegralOverflow)
+{
+	DynamicUnit<int> d = IntMeters(3000000);
+	EXPECT_THROW(d.to_static<IntMillimeters>(), std::overflow_error);
+	EXPECT_THROW(d.rescaled(Scale{ 1, 1000 }), std::overflow_error);
+
+	DynamicUnit<long long> big = Unit<long long, Length<meter>>(3000000);
+	EXPECT_THROW(big.to_static<IntMillimeters>(), std::overflow_error);
+	EXPECT_EQ(3000000000ll, (big.to_static<Unit<long long, Length<std::milli>>>().value()));
+}
+
+TEST(UnitDynamicTest, Arithmetic)
+{
+	const DynamicUnit<float> a = Meters(2);
+	const DynamicUnit<float> b = Centimeters(50);
+
+	DynamicUnit<float> sum = a + b;
+	EXPECT_FLOAT_EQ(2.5f, sum.to_static<Meters>().value());
+	EXPECT_FLOAT_EQ(1.5f, (a - b).to_static<Meters>().value());
+	EXPECT_FLOAT_EQ(-2.f, (-a).to_static<Meters>().value());
+
+	const DynamicUnit<float> area = a * b;
+	EXPECT_EQ(Dim<2>::code, area.dim());
+	EXPECT_FLOAT_EQ(1.f, area.to_static<Meters2>().value());
+
+	const DynamicUnit<float> speed = a / DynamicUnit<float>(Seconds(4));
+	EXPECT_FLOAT_EQ(0.5f, speed.to_static<m_s>().value());
+	EXPECT_FLOAT_EQ(1.f, (speed * 2).to_static<m_s>().value());
+	EXPECT_FLOAT_EQ(1.f, (2 * speed).to_static<m_s>().value());
+	EXPECT_FLOAT_EQ(0.25f, (speed / 2).to_static<m_s>().value());
+
+	sum += b;
+	sum *= 2;
+	EXPECT_FLOAT_EQ(6.f, sum.to_static<Meters>().value());
+
+	EXPECT_TRUE(DynamicUnit<float>(Meters(1)) == DynamicUnit<float>(Centimeters(100)));
+	EXPECT_TRUE(b < a);
+	EXPECT_TRUE(a > b);
+	EXPECT_TRUE(a != b);
+}
+
+TEST(UnitDynamicTest, ChecksDimensions)
+{
+	const DynamicUnit<float> m = Meters(2);
+	const DynamicUnit<float> s = Seconds(2);
+	EXPECT_THROW(m + s, std::invalid_argument);
+	EXPECT_THROW(m - s, std::invalid_argument);
+	EXPECT_THROW((void)(m < s), std::invalid_argument);
+	EXPECT_THROW((void)(m == s), std::invalid_argument);
+
+	// Exponents out of the range of Dim
+	DynamicUnit<float> p = m;
+	for (int i = 0; i < 6; ++i)
+		p = p * m;
+	EXPECT_EQ(7, dim_exponent(p.dim(), 0));
+	EXPECT_THROW(p * m, std::overflow_error);
+}
+
+TEST(UnitDynamicTest, Parse)
+{
+	DynamicUnit<float> d;
+	const string s = "5.4 km/h";
+	const ParseResult r = parse(s.data(), s.data() + s.size(), d);
+	EXPECT_TRUE(bool(r));
+	EXPECT_EQ(s.data() + s.size(), r.ptr);
+	EXPECT_EQ((Dim<1,-1>::code), d.dim());
+	EXPECT_FLOAT_EQ(1.5f, d.to_static<m_s>().value());
+	EXPECT_THROW(d.to_static<Meters>(), std::invalid_argument);
+
+	const string bad = "5.4 furlongs";
+	EXPECT_EQ(ParseError::symbol, parse(bad.data(), bad.data() + bad.size(), d).error);
+}
@@ -0,0 +1,234 @@
+#ifndef SIMPLEUNIT_UNITEXPR_H
+#define SIMPLEUNIT_UNITEXPR_H
+
+#include "simpleunit/UnitArray.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace sunit {
+
+// Lazy, element-wise arithmetic over spans and arrays of units.
+//
+// An expression like `width * height / time` over arrays builds a tree of nodes rather
+// than intermediate arrays. Each node's `unit_type` is the type the scalar Unit operators
+// give for its operands, so dimensions are checked and the result type is known at compile
+// time. Nothing is computed until the expression is assigned (`assign`) or evaluated
+// (`evaluate`), in a single pass with no temporaries.
+//
+// Expressions hold views of their operands, so must be evaluated while those are alive.
+
+namespace expr {
+
+struct Plus {
+	template <typename A, typename B>
+	constexpr auto operator()(const A& a, const B& b) const -> decltype(a + b) { return a + b; }
+};
+
+struct Minus {
+	template <typename A, typename B>
+	constexpr auto operator()(const A& a, const B& b) const -> decltype(a - b) { return a - b; }
+};
+
+struct Multiplies {
+	template <typename A, typename B>
+	constexpr auto operator()(const A& a, const B& b) const -> decltype(a * b) { return a * b; }
+};
+
+struct Divides {
+	template <typename A, typename B>
+	constexpr auto operator()(const A& a, const B& b) const -> decltype(a / b) { return a / b; }
+};
+
+// Leaf over a span of units
+template <typename T, typename B, typename P = FinestScale>
+class SpanExpr
+{
+public:
+	using unit_type = Unit<T,B,P>;
+	static constexpr bool broadcast = false;
+
+	explicit SpanExpr(UnitSpan<const T,B,P> span) : span_(span) {}
+
+	std::size_t size() const { return span_.size(); }
+	const unit_type& operator[](std::size_t i) const { return span_[i]; }
+
+private:
+	UnitSpan<const T,B,P> span_;
+};
+
+// Leaf broadcasting a single Unit or arithmetic value to every index, of any size
+template <typename V>
+class ScalarExpr
+{
+public:
+	using unit_type = V;
+	static constexpr bool broadcast = true;
+
+	explicit constexpr ScalarExpr(const V& value) : value_(value) {}
+
+	constexpr const V& operator[](std::size_t) const { return value_; }
+
+private:
+	V value_;
+};
+
+template <typename Op, typename L, typename R>
+class BinaryExpr
+{
+public:
+	using unit_type = decltype(Op()(std::declval<typename L::unit_type>(), std::declval<typename R::unit_type>()));
+	static constexpr bool broadcast = L::broadcast && R::broadcast;
+
+	BinaryExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+		if constexpr (!L::broadcast && !R::broadcast)
+			assert(lhs_.size() == rhs_.size());
+	}
+
+	std::size_t size() const {
+		if constexpr (L::broadcast)
+			return rhs_.size();
+		else
+			return lhs_.size();
+	}
+	unit_type operator[](std::size_t i) const { return Op()(lhs_[i], rhs_[i]); }
+
+private:
+	L lhs_;
+	R rhs_;
+};
+
+// Maps each kind of operand to its node. Only spans, arrays and nodes over them are
+// array operands; at least one operand of an expression operator must be one.
+template <typename E, typename = void>
+struct Operand { static constexpr bool valid = false; static constexpr bool array = false; };
+
+template <typename T, typename B, typename P>
+struct Operand<UnitSpan<T,B,P>> {
+	static constexpr bool valid = true;
+	static constexpr bool array = true;
+	using node = SpanExpr<std::remove_const_t<T>, B, P>;
+	static node make(const UnitSpan<T,B,P>& s) { return node(s); }
+};
+
+template <typename T, typename B, typename P>
+struct Operand<UnitArray<T,B,P>> {
+	static constexpr bool valid = true;
+	static constexpr bool array = true;
+	using node = SpanExpr<T,B,P>;
+	static node make(const UnitArray<T,B,P>& a) { return node(a.span()); }
+};
+
+template <typename T, typename B, typename P>
+struct Operand<SpanExpr<T,B,P>> {
+	static constexpr bool valid = true;
+	static constexpr bool array = true;
+	using node = SpanExpr<T,B,P>;
+	static const node& make(const node& e) { return e; }
+};
+
+template <typename Op, typename L, typename R>
+struct Operand<BinaryExpr<Op,L,R>> {
+	static constexpr bool valid = true;
+	static constexpr bool array = true;
+	using node = BinaryExpr<Op,L,R>;
+	static const node& make(const node& e) { return e; }
+};
+
+template <typename T, typename B, typename P>
+struct Operand<Unit<T,B,P>> {
+	static constexpr bool valid = true;
+	static constexpr bool array = false;
+	using node = ScalarExpr<Unit<T,B,P>>;
+	static node make(const Unit<T,B,P>& u) { return node(u); }
+};
+
+template <typename T>
+struct Operand<T, std::enable_if_t<std::is_arithmetic<T>::value>> {
+	static constexpr bool valid = true;
+	static constexpr bool array = false;
+	using node = ScalarExpr<T>;
+	static node make(const T& v) { return node(v); }
+};
+
+template <typename L, typename R>
+using IsExprOperands = std::integral_constant<bool,
+	Operand<L>::valid && Operand<R>::valid && (Operand<L>::array || Operand<R>::array)>;
+
+template <typename Op, typename L, typename R>
+using ExprType = BinaryExpr<Op, typename Operand<L>::node, typename Operand<R>::node>;
+
+// Substitution fails here, rather than inside BinaryExpr, for operands of invalid dimensions
+template <typename Op, typename L, typename R>
+using ExprUnit = decltype(Op()(std::declval<typename Operand<L>::node::unit_type>(),
+                               std::declval<typename Operand<R>::node::unit_type>()));
+
+template <typename Op, typename L, typename R>
+ExprType<Op,L,R> make_expr(const L& lhs, const R& rhs)
+{
+	return ExprType<Op,L,R>(Operand<L>::make(lhs), Operand<R>::make(rhs));
+}
+
+} // expr
+
+template <typename E>
+using IsArrayExpr = std::integral_constant<bool, expr::Operand<E>::array>;
+
+// Array + - * / (array | Unit | scalar), in either order
+
+template <typename L, typename R, typename = std::enable_if_t<expr::IsExprOperands<L,R>::value>,
+          typename = expr::ExprUnit<expr::Plus,L,R>>
+expr::ExprType<expr::Plus,L,R> operator+(const L& lhs, const R& rhs)
+{
+	return expr::make_expr<expr::Plus>(lhs, rhs);
+}
+
+template <typename L, typename R, typename = std::enable_if_t<expr::IsExprOperands<L,R>::value>,
+          typename = expr::ExprUnit<expr::Minus,L,R>>
+expr::ExprType<expr::Minus,L,R> operator-(const L& lhs, const R& rhs)
+{
+	return expr::make_expr<expr::Minus>(lhs, rhs);
+}
+
+template <typename L, typename R, typename = std::enable_if_t<expr::IsExprOperands<L,R>::value>,
+          typename = expr::ExprUnit<expr::Multiplies,L,R>>
+expr::ExprType<expr::Multiplies,L,R> operator*(const L& lhs, const R& rhs)
+{
+	return expr::make_expr<expr::Multiplies>(lhs, rhs);
+}
+
+template <typename L, typename R, typename = std::enable_if_t<expr::IsExprOperands<L,R>::value>,
+          typename = expr::ExprUnit<expr::Divides,L,R>>
+expr::ExprType<expr::Divides,L,R> operator/(const L& lhs, const R& rhs)
+{
+	return expr::make_expr<expr::Divides>(lhs, rhs);
+}
+
+// Evaluate an expression into dst in a single pass. Each element converts to the
+// destination unit as a Unit would on assignment, so lossy conversions do not compile.
+template <typename T, typename B, typename P, typename E, typename = std::enable_if_t<IsArrayExpr<E>::value>>
+void assign(UnitSpan<T,B,P> dst, const E& e)
+{
+	const auto& node = expr::Operand<E>::make(e);
+	assert(dst.size() == node.size());
+
+	T* out = dst.data();
+	const std::size_t n = dst.size();
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = Unit<T,B,P>(node[i]).value();
+}
+
+// Evaluate an expression into a new array of its own unit type
+template <typename E, typename U = typename expr::Operand<E>::node::unit_type>
+ArrayOf<U> evaluate(const E& e)
+{
+	ArrayOf<U> result(expr::Operand<E>::make(e).size());
+	assign(result.span(), e);
+	return result;
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITEXPR_H
@@ -0,0 +1,74 @@
+#include "simpleunit/UnitExpr.h"
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// flowrate = width * height / time, over arrays from L1-resident up to DRAM
+
+static void ExprArgs(benchmark::internal::Benchmark* b)
+{
+	for (long n = 1 << 10; n <= 1 << 24; n <<= 2)
+		b->Arg(n);
+}
+
+static void SetBandwidth(benchmark::State& state)
+{
+	// Three arrays read and one written
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * 4 * sizeof(float));
+}
+
+// One array per operator, as written without expression templates
+static void BM_FlowrateTemporaries(benchmark::State& state)
+{
+	ArrayOf<Centimeters> width(state.range(0), Centimeters(200));
+	ArrayOf<Meters> height(state.range(0), Meters(5));
+	ArrayOf<Seconds> time(state.range(0), Seconds(132));
+	using Area = decltype(width[0] * height[0]);
+	using Flow = decltype(width[0] * height[0] / time[0]);
+	ArrayOf<Area> area(width.size());
+	ArrayOf<Flow> flowrate(width.size());
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < width.size(); ++i)
+			area[i] = width[i] * height[i];
+		for (size_t i = 0; i < width.size(); ++i)
+			flowrate[i] = area[i] / time[i];
+		benchmark::DoNotOptimize(flowrate.data());
+		benchmark::ClobberMemory();
+	}
+	SetBandwidth(state);
+}
+BENCHMARK(BM_FlowrateTemporaries)->Apply(ExprArgs);
+
+static void BM_FlowrateFused(benchmark::State& state)
+{
+	ArrayOf<Centimeters> width(state.range(0), Centimeters(200));
+	ArrayOf<Meters> height(state.range(0), Meters(5));
+	ArrayOf<Seconds> time(state.range(0), Seconds(132));
+	ArrayOf<decltype(width[0] * height[0] / time[0])> flowrate(width.size());
+
+	for (auto _ : state) {
+		assign(flowrate.span(), width * height / time);
+		benchmark::DoNotOptimize(flowrate.data());
+		benchmark::ClobberMemory();
+	}
+	SetBandwidth(state);
+}
+BENCHMARK(BM_FlowrateFused)->Apply(ExprArgs);
+
+// The same computation on raw floats, with the conversion written by hand
+static void BM_FlowrateRaw(benchmark::State& state)
+{
+	std::vector<float> width(state.range(0), 200.f), height(state.range(0), 5.f), time(state.range(0), 132.f);
+	std::vector<float> flowrate(width.size());
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < width.size(); ++i)
+			flowrate[i] = width[i] * (height[i] * 100.f) / time[i];
+		benchmark::DoNotOptimize(flowrate.data());
+		benchmark::ClobberMemory();
+	}
+	SetBandwidth(state);
+}
+BENCHMARK(BM_FlowrateRaw)->Apply(ExprArgs);
@@ -0,0 +1,115 @@
+#include "simpleunit/UnitExpr.h"
+#include <type_traits>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	template <typename L, typename R, typename = void>
+	struct CanAdd : false_type {};
+
+	template <typename L, typename R>
+	struct CanAdd<L, R, decltype(void(declval<L>() + declval<R>()))> : true_type {};
+}
+
+TEST(UnitExprTest, ReadmeExample)
+{
+	ArrayOf<Meters> height = { Meters(5), Meters(1), Meters(0.5f) };
+	ArrayOf<Centimeters> width = { Centimeters(200), Centimeters(10), Centimeters(3) };
+	ArrayOf<Seconds> time = { Seconds(132), Seconds(2), Seconds(4) };
+
+	auto e = width * height / time;
+
+	// The result type is that of the equivalent scalar expression
+	using Scalar = decltype(width[0] * height[0] / time[0]);
+	static_assert(is_same<decltype(e)::unit_type, Scalar>::value, "");
+	EXPECT_EQ(3u, e.size());
+
+	auto flowrate = evaluate(e);
+	static_assert(is_same<decltype(flowrate), ArrayOf<Scalar>>::value, "");
+	for (size_t i = 0; i < 3; ++i)
+		EXPECT_FLOAT_EQ((width[i] * height[i] / time[i]).value(), flowrate[i].value());
+	EXPECT_FLOAT_EQ(757.57574f, flowrate[0].value());
+
+	// Assigning into another unit converts each element once
+	ArrayOf<Meters2_Second> m2s(3);
+	assign(m2s.span(), e);
+	EXPECT_FLOAT_EQ(0.075757574f, m2s[0].value());
+}
+
+TEST(UnitExprTest, MixedOperands)
+{
+	ArrayOf<Meters> a = { Meters(1), Meters(2) };
+	float raw[] = { 10.f, 20.f };
+	auto b = unit_span<Centimeters>(raw, 2);
+
+	// Spans, arrays, Units and scalars, in either order
+	auto sum = evaluate(a + b);
+	static_assert(is_same<decltype(sum)::unit_type, Centimeters>::value, "");
+	EXPECT_FLOAT_EQ(110.f, sum[0].value());
+	EXPECT_FLOAT_EQ(220.f, sum[1].value());
+
+	auto diff = evaluate(Meters(3) - a);
+	EXPECT_FLOAT_EQ(1.f, diff[1].value());
+
+	auto scaled = evaluate(2 * a * 0.5f + b);
+	EXPECT_FLOAT_EQ(220.f, scaled[1].value());
+
+	auto speed = evaluate(a / Seconds(2));
+	static_assert(is_same<decltype(speed)::unit_type::base::dim, Meters_Second::base::dim>::value, "");
+	EXPECT_FLOAT_EQ(1.f, speed[1].value());
+
+	// Evaluating in place
+	assign(a.span(), a * 3 + b);
+	EXPECT_FLOAT_EQ(3.1f, a[0].value());
+	EXPECT_FLOAT_EQ(6.2f, a[1].value());
+}
+
+TEST(UnitExprTest, EmptyOperands)
+{
+	// An empty array is an array of no elements, not a broadcast
+	ArrayOf<Meters> none;
+	EXPECT_EQ(0u, (none + Meters(1)).size());
+	EXPECT_EQ(0u, (2.f * none * none).size());
+	EXPECT_EQ(0u, evaluate(none - none).size());
+
+	// Units of any policy broadcast
+	using LeftCentimeters = WithPolicy<Centimeters, LeftScale>;
+	ArrayOf<Meters> a = { Meters(1), Meters(2) };
+	auto sum = evaluate(LeftCentimeters(50) + a);
+	static_assert(is_same<decltype(sum)::unit_type, LeftCentimeters>::value, "");
+	EXPECT_FLOAT_EQ(250.f, sum[1].value());
+}
+
+TEST(UnitExprTest, DimensionChecks)
+{
+	static_assert(CanAdd<ArrayOf<Meters>, ArrayOf<Centimeters>>::value, "");
+	static_assert(CanAdd<ArrayOf<Meters>, Centimeters>::value, "");
+	static_assert(!CanAdd<ArrayOf<Meters>, ArrayOf<Seconds>>::value, "");
+	static_assert(!CanAdd<ArrayOf<Meters>, Seconds>::value, "");
+	static_assert(!CanAdd<SpanOf<Meters>, SpanOf<Seconds>>::value, "");
+
+	// Elements keep their scale policy, so strict arrays combine as strict units do
+	using StrictSum = decltype(declval<ArrayOf<strict::Meters>>() + declval<SpanOf<strict::Meters>>());
+	static_assert(is_same<StrictSum::unit_type, strict::Meters>::value, "");
+	static_assert(is_same<decltype(evaluate(declval<StrictSum>())), ArrayOf<strict::Meters>>::value, "");
+
+	// Plain scalars and units are not array expressions
+	static_assert(!IsArrayExpr<Meters>::value, "");
+	static_assert(!IsArrayExpr<float>::value, "");
+	static_assert(IsArrayExpr<ConstSpanOf<Meters>>::value, "");
+}
+
+TEST(UnitExprTest, IntegralUnits)
+{
+	UnitArray<int, BaseRatio<4,3>> a = { Unit<int, BaseRatio<4,3>>(10), Unit<int, BaseRatio<4,3>>(20) };
+	UnitArray<int, BaseRatio<1,3>> b = { Unit<int, BaseRatio<1,3>>(40), Unit<int, BaseRatio<1,3>>(1) };
+
+	auto sum = evaluate(a + b);
+	static_assert(is_same<decltype(sum)::unit_type, Unit<int, BaseRatio<1,3>>>::value, "");
+	EXPECT_EQ(80, sum[0].value());
+	EXPECT_EQ(81, sum[1].value());
+}
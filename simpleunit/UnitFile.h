@@ -0,0 +1,359 @@
+#ifndef SIMPLEUNIT_UNITFILE_H
+#define SIMPLEUNIT_UNITFILE_H
+
+#include "simpleunit/UnitArray.h"
+#include "simpleunit/UnitConversion.h"
+#include "simpleunit/UnitScale.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sunit {
+
+// A self-describing binary file of unit-typed columns.
+//
+// Each column records its rep, its `Dim` code and the ratios r1 .. r7 of its BaseUnit along
+// with the raw values, so a file carries its own units. `UnitFile` maps a file into memory
+// and opens columns as a given Unit type. The dimensions are checked when a column is
+// opened. Where the stored rep and scale match the requested Unit, the column is a view of
+// the mapped data with no copy. Otherwise it's converted on first access, in a single pass.
+//
+//     UnitFileWriter out("depths.sunit");
+//     out.write("depth", depths.span());          // e.g. a UnitArray of Centimeters
+//     out.close();
+//
+//     UnitFile in("depths.sunit");
+//     auto depth = in.column<si::Meters>("depth"); // checked: a length
+//     for (si::Meters d : depth.span()) ..         // converted, once, from cm
+//
+// Files are written and read in the byte order of the host, which is recorded and checked.
+
+enum class RepCode : std::uint32_t {
+	f32 = 1, f64, i8, i16, i32, i64, u8, u16, u32, u64
+};
+
+// The layout of the file, and the conversion of stored values
+namespace file {
+
+template <typename T> struct RepCodeOf;
+template <> struct RepCodeOf<float>         { static constexpr RepCode value = RepCode::f32; };
+template <> struct RepCodeOf<double>        { static constexpr RepCode value = RepCode::f64; };
+template <> struct RepCodeOf<std::int8_t>   { static constexpr RepCode value = RepCode::i8; };
+template <> struct RepCodeOf<std::int16_t>  { static constexpr RepCode value = RepCode::i16; };
+template <> struct RepCodeOf<std::int32_t>  { static constexpr RepCode value = RepCode::i32; };
+template <> struct RepCodeOf<std::int64_t>  { static constexpr RepCode value = RepCode::i64; };
+template <> struct RepCodeOf<std::uint8_t>  { static constexpr RepCode value = RepCode::u8; };
+template <> struct RepCodeOf<std::uint16_t> { static constexpr RepCode value = RepCode::u16; };
+template <> struct RepCodeOf<std::uint32_t> { static constexpr RepCode value = RepCode::u32; };
+template <> struct RepCodeOf<std::uint64_t> { static constexpr RepCode value = RepCode::u64; };
+
+inline std::size_t rep_size(RepCode rep)
+{
+	switch (rep) {
+	case RepCode::i8:  case RepCode::u8:  return 1;
+	case RepCode::i16: case RepCode::u16: return 2;
+	case RepCode::f32: case RepCode::i32: case RepCode::u32: return 4;
+	case RepCode::f64: case RepCode::i64: case RepCode::u64: return 8;
+	}
+	return 0;
+}
+
+constexpr char magic[8] = { 'S', 'U', 'N', 'I', 'T', 'C', 'O', 'L' };
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t byte_order = 0x01020304;
+constexpr std::size_t alignment = 64;   // of each column's data
+
+struct Header {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byte_order;
+	std::uint64_t columns;
+	std::uint64_t directory;                 // offset of the ColumnHeaders
+};
+
+struct ColumnHeader {
+	char name[48];                           // null terminated
+	std::uint32_t rep;                       // RepCode
+	std::uint32_t dim;                       // DimCode
+	std::int64_t ratios[dim_count][2];       // num, den of r1 .. r7
+	std::uint64_t count;
+	std::uint64_t offset;                    // of the data, from the start of the file
+};
+
+template <typename B, std::size_t... I>
+void base_ratios(std::int64_t (&ratios)[dim_count][2], std::index_sequence<I...>)
+{
+	((ratios[I][0] = RatioAt<B,I>::num, ratios[I][1] = RatioAt<B,I>::den), ...);
+}
+
+// The scale of a stored column: the product of each r^d
+inline Scale stored_scale(const ColumnHeader& column)
+{
+	Scale result{ 1, 1 };
+	for (std::size_t i = 0; i < dim_count; ++i)
+		result = scale_multiply(result, scale_pow(Scale{ column.ratios[i][0], column.ratios[i][1] },
+		                                          dim_exponent(column.dim, i)));
+	return result;
+}
+
+template <typename Y>
+void convert_column(const void* in, RepCode rep, Y* out, std::size_t n, Scale r)
+{
+	switch (rep) {
+	case RepCode::f32: return convert_values(static_cast<const float*>(in), out, n, r);
+	case RepCode::f64: return convert_values(static_cast<const double*>(in), out, n, r);
+	case RepCode::i8:  return convert_values(static_cast<const std::int8_t*>(in), out, n, r);
+	case RepCode::i16: return convert_values(static_cast<const std::int16_t*>(in), out, n, r);
+	case RepCode::i32: return convert_values(static_cast<const std::int32_t*>(in), out, n, r);
+	case RepCode::i64: return convert_values(static_cast<const std::int64_t*>(in), out, n, r);
+	case RepCode::u8:  return convert_values(static_cast<const std::uint8_t*>(in), out, n, r);
+	case RepCode::u16: return convert_values(static_cast<const std::uint16_t*>(in), out, n, r);
+	case RepCode::u32: return convert_values(static_cast<const std::uint32_t*>(in), out, n, r);
+	case RepCode::u64: return convert_values(static_cast<const std::uint64_t*>(in), out, n, r);
+	}
+}
+
+} // file
+
+class UnitFileWriter
+{
+public:
+	explicit UnitFileWriter(const std::string& path) : out_(path, std::ios::binary | std::ios::trunc) {
+		if (!out_)
+			throw std::runtime_error("sunit: can't open " + path + " for writing");
+		const file::Header header = {};
+		put(&header, sizeof(header));
+	}
+
+	UnitFileWriter(const UnitFileWriter&) = delete;
+	UnitFileWriter& operator=(const UnitFileWriter&) = delete;
+
+	~UnitFileWriter() {
+		if (out_.is_open()) {
+			try { close(); } catch (...) {}
+		}
+	}
+
+	// Append a column of units
+	template <typename T, typename B, typename P>
+	void write(const std::string& name, UnitSpan<T,B,P> values) {
+		using R = std::remove_const_t<T>;
+		if (name.size() >= sizeof(file::ColumnHeader::name))
+			throw std::invalid_argument("sunit: column name too long: " + name);
+
+		file::ColumnHeader column = {};
+		std::memcpy(column.name, name.data(), name.size());
+		column.rep = static_cast<std::uint32_t>(file::RepCodeOf<R>::value);
+		column.dim = B::dim::code;
+		file::base_ratios<B>(column.ratios, DimIndices());
+		column.count = values.size();
+		column.offset = pad(file::alignment);
+		put(values.data(), values.size() * sizeof(R));
+		columns_.push_back(column);
+	}
+
+	template <typename T, typename B, typename P>
+	void write(const std::string& name, const UnitArray<T,B,P>& values) { write(name, values.span()); }
+
+	// Write the column directory and header. Called on destruction if not called before.
+	void close() {
+		file::Header header = {};
+		std::memcpy(header.magic, file::magic, sizeof(file::magic));
+		header.version = file::version;
+		header.byte_order = file::byte_order;
+		header.columns = columns_.size();
+		header.directory = pad(alignof(file::ColumnHeader));
+		put(columns_.data(), columns_.size() * sizeof(file::ColumnHeader));
+		out_.seekp(0);
+		put(&header, sizeof(header));
+		out_.close();
+		if (!out_)
+			throw std::runtime_error("sunit: error writing unit file");
+	}
+
+private:
+	void put(const void* data, std::size_t size) {
+		out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		if (!out_)
+			throw std::runtime_error("sunit: error writing unit file");
+	}
+
+	// Pad the file to a multiple of boundary, returning the new offset
+	std::uint64_t pad(std::size_t boundary) {
+		const std::uint64_t offset = static_cast<std::uint64_t>(out_.tellp());
+		const std::uint64_t padding = (boundary - offset % boundary) % boundary;
+		const char zeros[file::alignment] = {};
+		put(zeros, padding);
+		return offset + padding;
+	}
+
+	std::ofstream out_;
+	std::vector<file::ColumnHeader> columns_;
+};
+
+// A column opened as Unit type U: a view of the mapped file, or converted on first access.
+// Valid only while the UnitFile it was opened from is alive.
+template <typename U>
+class UnitColumn
+{
+public:
+	using rep = typename U::rep;
+	using base = typename U::base;
+	using unit_type = U;
+
+	UnitColumn(const void* data, std::size_t size, RepCode stored, Scale conversion)
+		: data_(data), size_(size), stored_(stored), conversion_(conversion) {}
+
+	std::size_t size() const { return size_; }
+
+	// True if the column is used in place, with no conversion
+	bool zero_copy() const {
+		return stored_ == file::RepCodeOf<rep>::value && conversion_.num == 1 && conversion_.den == 1;
+	}
+
+	// The values as units of U, converting all of them on the first call if need be
+	ConstSpanOf<U> span() {
+		if (zero_copy())
+			return ConstSpanOf<U>(static_cast<const rep*>(data_), size_);
+		if (converted_.size() != size_) {
+			converted_.resize(size_);
+			file::convert_column(data_, stored_, converted_.data(), size_, conversion_);
+		}
+		return converted_.span();
+	}
+
+private:
+	const void* data_;
+	std::size_t size_;
+	RepCode stored_;
+	Scale conversion_;
+	ArrayOf<U> converted_;
+};
+
+class UnitFile
+{
+public:
+	explicit UnitFile(const std::string& path) {
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw std::runtime_error("sunit: can't open " + path);
+		struct stat st;
+		if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(file::Header))) {
+			::close(fd);
+			throw std::runtime_error("sunit: not a unit file: " + path);
+		}
+		size_ = static_cast<std::size_t>(st.st_size);
+		void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (map == MAP_FAILED)
+			throw std::runtime_error("sunit: can't map " + path);
+		data_ = static_cast<const char*>(map);
+
+		try {
+			validate(path);
+		}
+		catch (...) {
+			::munmap(const_cast<char*>(data_), size_);
+			throw;
+		}
+	}
+
+	UnitFile(UnitFile&& other) noexcept : data_(other.data_), size_(other.size_) {
+		other.data_ = nullptr;
+		other.size_ = 0;
+	}
+
+	UnitFile& operator=(UnitFile&& other) noexcept {
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		return *this;
+	}
+
+	~UnitFile() {
+		if (data_)
+			::munmap(const_cast<char*>(data_), size_);
+	}
+
+	std::size_t columns() const { return header().columns; }
+
+	std::string name(std::size_t i) const { return directory()[i].name; }
+
+	bool contains(const std::string& name) const { return find(name) != nullptr; }
+
+	// Open a column as units of U, which must have the dimensions of the stored column
+	template <typename U>
+	UnitColumn<U> column(const std::string& name) const {
+		using B = typename U::base;
+		const file::ColumnHeader* column = find(name);
+		if (!column)
+			throw std::out_of_range("sunit: no column " + name);
+		if (column->dim != B::dim::code)
+			throw std::invalid_argument("sunit: column " + name + " has other dimensions than the requested unit");
+		const UnitSignature stored{ column->dim, file::stored_scale(*column) };
+		return UnitColumn<U>(data_ + column->offset, column->count, static_cast<RepCode>(column->rep),
+		                     conversions().get(stored, signature_of<B>()).scale);
+	}
+
+private:
+	const file::Header& header() const { return *reinterpret_cast<const file::Header*>(data_); }
+
+	const file::ColumnHeader* directory() const {
+		return reinterpret_cast<const file::ColumnHeader*>(data_ + header().directory);
+	}
+
+	const file::ColumnHeader* find(const std::string& name) const {
+		for (std::size_t i = 0; i < columns(); ++i)
+			if (name == directory()[i].name)
+				return &directory()[i];
+		return nullptr;
+	}
+
+	void validate(const std::string& path) const {
+		const file::Header& h = header();
+		const auto fail = [&](const char* what) {
+			throw std::runtime_error("sunit: " + path + ": " + what);
+		};
+		if (std::memcmp(h.magic, file::magic, sizeof(file::magic)) != 0)
+			fail("not a unit file");
+		if (h.version != file::version)
+			fail("unsupported version");
+		if (h.byte_order != file::byte_order)
+			fail("written with another byte order");
+		if (h.directory % alignof(file::ColumnHeader) != 0 || h.directory > size_ ||
+		    h.columns > (size_ - h.directory) / sizeof(file::ColumnHeader))
+			fail("corrupt column directory");
+
+		for (std::size_t i = 0; i < h.columns; ++i) {
+			const file::ColumnHeader& c = directory()[i];
+			const std::size_t element = file::rep_size(static_cast<RepCode>(c.rep));
+			if (std::memchr(c.name, 0, sizeof(c.name)) == nullptr)
+				fail("corrupt column name");
+			if (element == 0)
+				fail("unknown column rep");
+			for (const auto& r : c.ratios)
+				if (r[0] <= 0 || r[1] <= 0)
+					fail("corrupt column ratio");
+			if (c.offset % file::alignment != 0 || c.offset > size_ || c.count > (size_ - c.offset) / element)
+				fail("corrupt column extent");
+		}
+	}
+
+	const char* data_ = nullptr;
+	std::size_t size_ = 0;
+};
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITFILE_H
@@ -0,0 +1,89 @@
+#include "simpleunit/UnitFile.h"
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Loading a column of n floats and touching every value: raw floats read with an ifstream,
+// against a unit file mapped in place or converted from another scale on load
+
+namespace
+{
+	const std::string raw_path = "simpleunit_bench_raw.bin";
+	const std::string unit_path = "simpleunit_bench.sunit";
+
+	void write_files(size_t n)
+	{
+		ArrayOf<Centimeters> depth(n, Centimeters(150));
+		std::ofstream raw(raw_path, std::ios::binary | std::ios::trunc);
+		raw.write(reinterpret_cast<const char*>(depth.data()), n * sizeof(float));
+
+		UnitFileWriter out(unit_path);
+		out.write("depth", depth);
+	}
+
+	template <typename S>
+	float sum(S span)
+	{
+		float total = 0.f;
+		for (const auto& x : span)
+			total += x.value();
+		return total;
+	}
+}
+
+static void FileArgs(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 16)->Arg(1 << 22);
+}
+
+static void BM_FileReadRaw(benchmark::State& state)
+{
+	const size_t n = state.range(0);
+	write_files(n);
+	for (auto _ : state) {
+		std::ifstream in(raw_path, std::ios::binary);
+		std::vector<float> values(n);
+		in.read(reinterpret_cast<char*>(values.data()), n * sizeof(float));
+		benchmark::DoNotOptimize(std::accumulate(values.begin(), values.end(), 0.f));
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * n * sizeof(float));
+	std::remove(raw_path.c_str());
+	std::remove(unit_path.c_str());
+}
+BENCHMARK(BM_FileReadRaw)->Apply(FileArgs);
+
+static void BM_FileZeroCopy(benchmark::State& state)
+{
+	const size_t n = state.range(0);
+	write_files(n);
+	for (auto _ : state) {
+		UnitFile in(unit_path);
+		auto depth = in.column<Centimeters>("depth");
+		benchmark::DoNotOptimize(sum(depth.span()));
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * n * sizeof(float));
+	std::remove(raw_path.c_str());
+	std::remove(unit_path.c_str());
+}
+BENCHMARK(BM_FileZeroCopy)->Apply(FileArgs);
+
+static void BM_FileConvert(benchmark::State& state)
+{
+	const size_t n = state.range(0);
+	write_files(n);
+	for (auto _ : state) {
+		UnitFile in(unit_path);
+		auto depth = in.column<Meters>("depth");
+		benchmark::DoNotOptimize(sum(depth.span()));
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * n * sizeof(float));
+	std::remove(raw_path.c_str());
+	std::remove(unit_path.c_str());
+}
+BENCHMARK(BM_FileConvert)->Apply(FileArgs);
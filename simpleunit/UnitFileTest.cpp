@@ -0,0 +1,164 @@
+#include "simpleunit/UnitFile.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	string temp_path(const string& name)
+	{
+		return testing::TempDir() + "simpleunit_" + name + ".sunit";
+	}
+
+	using IntMillimeters = Unit<int, Length<std::milli>>;
+	using IntMeters = Unit<int, Length<meter>>;
+	using DoubleMeters_Second = Unit<double, Velocity<meter, second>>;
+}
+
+TEST(UnitFileTest, ZeroCopy)
+{
+	const string path = temp_path("zero_copy");
+	ArrayOf<Meters> depth = { Meters(1.5f), Meters(-2), Meters(40) };
+	{
+		UnitFileWriter out(path);
+		out.write("depth", depth);
+		out.write("time", ArrayOf<Seconds>(5, Seconds(3)));
+	}
+
+	UnitFile in(path);
+	EXPECT_EQ(2u, in.columns());
+	EXPECT_EQ("depth", in.name(0));
+	EXPECT_EQ("time", in.name(1));
+	EXPECT_TRUE(in.contains("time"));
+	EXPECT_FALSE(in.contains("speed"));
+
+	auto column = in.column<Meters>("depth");
+	EXPECT_TRUE(column.zero_copy());
+	auto span = column.span();
+	static_assert(is_same<decltype(span), ConstSpanOf<Meters>>::value, "");
+	ASSERT_EQ(3u, span.size());
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(span.data()) % 64);
+	EXPECT_FLOAT_EQ(1.5f, span[0].value());
+	EXPECT_FLOAT_EQ(-2.f, span[1].value());
+	EXPECT_FLOAT_EQ(40.f, span[2].value());
+
+	// Columns of the same file are views of the same mapping
+	EXPECT_EQ(span.data(), in.column<Meters>("depth").span().data());
+
+	auto time = in.column<Seconds>("time");
+	ASSERT_EQ(5u, time.size());
+	EXPECT_FLOAT_EQ(3.f, time.span()[4].value());
+
+	remove(path.c_str());
+}
+
+TEST(UnitFileTest, ConvertsScale)
+{
+	const string path = temp_path("convert");
+	{
+		UnitFileWriter out(path);
+		out.write("depth", ArrayOf<Centimeters>{ Centimeters(150), Centimeters(-20) });
+		out.write("speed", ArrayOf<in_hr>{ in_hr(39 * 3600) });
+		out.write("area", ArrayOf<Meters2>{ Meters2(2) });
+	}
+
+	UnitFile in(path);
+
+	auto depth = in.column<Meters>("depth");
+	EXPECT_FALSE(depth.zero_copy());
+	ASSERT_EQ(2u, depth.span().size());
+	EXPECT_FLOAT_EQ(1.5f, depth.span()[0].value());
+	EXPECT_FLOAT_EQ(-0.2f, depth.span()[1].value());
+
+	// Converted once: later calls give the same buffer
+	EXPECT_EQ(depth.span().data(), depth.span().data());
+
+	// inch/hour to meter/second, as 1/39 m per 3600 s
+	EXPECT_FLOAT_EQ(1.f, in.column<m_s>("speed").span()[0].value());
+
+	// Scales apply with the dimension's exponent
+	EXPECT_FLOAT_EQ(20000.f, in.column<Centimeters2>("area").span()[0].value());
+
+	remove(path.c_str());
+}
+
+TEST(UnitFileTest, ConvertsRep)
+{
+	const string path = temp_path("rep");
+	{
+		UnitFileWriter out(path);
+		out.write("depth", ArrayOf<IntMeters>{ IntMeters(3), IntMeters(-7) });
+		out.write("length", ArrayOf<IntMillimeters>{ IntMillimeters(2500) });
+		out.write("speed", ArrayOf<DoubleMeters_Second>{ DoubleMeters_Second(0.25) });
+	}
+
+	UnitFile in(path);
+	auto mm = in.column<IntMillimeters>("depth");
+	EXPECT_FALSE(mm.zero_copy());
+	EXPECT_EQ(3000, mm.span()[0].value());
+	EXPECT_EQ(-7000, mm.span()[1].value());
+
+	// Integral division truncates, as for unit_cast
+	EXPECT_EQ(2, in.column<IntMeters>("length").span()[0].value());
+	EXPECT_FLOAT_EQ(2.5f, in.column<Meters>("length").span()[0].value());
+
+	EXPECT_FLOAT_EQ(0.25f, in.column<m_s>("speed").span()[0].value());
+	EXPECT_TRUE(in.column<DoubleMeters_Second>("speed").zero_copy());
+
+	remove(path.c_str());
+}
+
+TEST(UnitFileTest, ChecksDimensions)
+{
+	const string path = temp_path("dims");
+	{
+		UnitFileWriter out(path);
+		out.write("depth", ArrayOf<Meters>{ Meters(1) });
+		out.write("current", ArrayOf<Milliamperes>{ Milliamperes(1) });
+	}
+
+	UnitFile in(path);
+	EXPECT_THROW(in.column<Seconds>("depth"), std::invalid_argument);
+	EXPECT_THROW(in.column<Meters2>("depth"), std::invalid_argument);
+	EXPECT_THROW(in.column<Meters>("current"), std::invalid_argument);
+	EXPECT_THROW(in.column<Meters>("missing"), std::out_of_range);
+	EXPECT_FLOAT_EQ(0.001f, in.column<Amperes>("current").span()[0].value());
+
+	remove(path.c_str());
+}
+
+TEST(UnitFileTest, RejectsBadFiles)
+{
+	EXPECT_THROW(UnitFile{ temp_path("does_not_exist") }, std::runtime_error);
+
+	const string path = temp_path("bad");
+	{
+		ofstream out(path, ios::binary);
+		out << "not a unit file, but long enough to hold a header";
+	}
+	EXPECT_THROW(UnitFile{ path }, std::runtime_error);
+
+	// A truncated file
+	{
+		UnitFileWriter out(path);
+		out.write("depth", ArrayOf<Meters>(1000, Meters(1)));
+	}
+	{
+		ifstream in(path, ios::binary);
+		string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+		ofstream out(path, ios::binary | ios::trunc);
+		out.write(data.data(), 1024);
+	}
+	EXPECT_THROW(UnitFile{ path }, std::runtime_error);
+
+	EXPECT_THROW(UnitFileWriter(path).write("a name much too long to fit in the header of a column", ArrayOf<Meters>()),
+	             std::invalid_argument);
+
+	remove(path.c_str());
+}
@@ -0,0 +1,267 @@
+#ifndef SIMPLEUNIT_UNITFORMAT_H
+#define SIMPLEUNIT_UNITFORMAT_H
+
+#include "simpleunit/Unit.h"
+#include "simpleunit/UnitScale.h"
+#include "simpleunit/UnitSymbols.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#if __has_include(<version>)
+#include <version>
+#endif
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+#ifdef SUNIT_FMT
+#include <fmt/format.h>
+#endif
+
+namespace sunit {
+
+// Formatting Units as text, like "757.57574 cm^2/s", without allocating.
+//
+// The symbol of each BaseUnit is built at compile time from its dimensions and ratios. Each
+// dimension is written with the symbol from UnitSymbols.h for its ratio, so
+// `Velocity<std::kilo, hour>` is "km/h", or as "(num/den m)" where the table has none.
+// Positive exponents come first, joined by '*', and each negative one follows a '/', so the
+// text parses back with sunit::parse. Values are written by std::to_chars, in the shortest
+// form that reads back exactly.
+//
+//     char buffer[sunit::format_size<si::m_s>];
+//     char* end = sunit::format_to(buffer, speed);           // "1.5 m/s"
+//     auto result = sunit::format_to(first, last, speed);    // or bounded, like std::to_chars
+//     std::cout << speed;
+//
+// Units are formatted by std::format where the library has it, and by fmt if SUNIT_FMT is
+// defined before including this header.
+
+namespace symbols {
+
+// A symbol built at compile time
+template <std::size_t N>
+struct UnitString {
+	char data[N + 1];
+
+	constexpr std::string_view view() const { return std::string_view(data, N); }
+};
+
+// Writes a symbol into out, or only counts its size where out is null
+struct SymbolWriter {
+	char* out;
+	std::size_t size;
+
+	constexpr void put(char c)
+	{
+		if (out)
+			out[size] = c;
+		++size;
+	}
+
+	constexpr void put(std::string_view s)
+	{
+		for (char c : s)
+			put(c);
+	}
+
+	constexpr void put_int(std::intmax_t n)
+	{
+		if (n < 0) {
+			put('-');
+			n = -n;
+		}
+		char digits[20] = {};
+		int k = 0;
+		do {
+			digits[k++] = static_cast<char>('0' + n % 10);
+			n /= 10;
+		} while (n != 0);
+		while (k != 0)
+			put(digits[--k]);
+	}
+};
+
+// The table's symbol for dimension i at scale s, or an empty view if there is none
+constexpr std::string_view lane_symbol(std::size_t i, Scale s)
+{
+	for (const UnitSymbol& u : table)
+		if (u.dim == dim_lane(1, i) && u.scale == s)
+			return u.symbol;
+	return std::string_view();
+}
+
+constexpr void write_lane(SymbolWriter& w, std::size_t i, Scale s, int exp)
+{
+	const std::string_view symbol = lane_symbol(i, s);
+	if (!symbol.empty()) {
+		w.put(symbol);
+	}
+	else {
+		w.put('(');
+		w.put_int(s.num);
+		if (s.den != 1) {
+			w.put('/');
+			w.put_int(s.den);
+		}
+		w.put(' ');
+		w.put(lane_symbol(i, Scale{ 1, 1 }));
+		w.put(')');
+	}
+	if (exp != 1) {
+		w.put('^');
+		w.put_int(exp);
+	}
+}
+
+template <typename B, std::size_t... I>
+constexpr void write_symbol(SymbolWriter& w, std::index_sequence<I...>)
+{
+	const Scale ratios[] = { scale_of<RatioAt<B,I>>()... };
+	bool first = true;
+	for (std::size_t i = 0; i < dim_count; ++i) {
+		const int exp = dim_exponent(B::dim::code, i);
+		if (exp > 0) {
+			if (!first)
+				w.put('*');
+			write_lane(w, i, ratios[i], exp);
+			first = false;
+		}
+	}
+	for (std::size_t i = 0; i < dim_count; ++i) {
+		const int exp = dim_exponent(B::dim::code, i);
+		if (exp < 0) {
+			if (!first)
+				w.put('/');
+			write_lane(w, i, ratios[i], first ? exp : -exp);
+			first = false;
+		}
+	}
+}
+
+template <typename B>
+constexpr std::size_t symbol_size()
+{
+	SymbolWriter w{ nullptr, 0 };
+	write_symbol<B>(w, DimIndices());
+	return w.size;
+}
+
+template <typename B>
+constexpr UnitString<symbol_size<B>()> make_symbol()
+{
+	UnitString<symbol_size<B>()> s{};
+	SymbolWriter w{ s.data, 0 };
+	write_symbol<B>(w, DimIndices());
+	return s;
+}
+
+template <typename B>
+struct SymbolOf {
+	static constexpr auto value = make_symbol<B>();
+};
+
+} // symbols
+
+// The symbol of base B, e.g. "cm^2/s", or an empty view if B is dimensionless
+template <typename B>
+constexpr std::string_view unit_symbol() { return symbols::SymbolOf<B>::value.view(); }
+
+template <typename T, typename B, typename P>
+constexpr std::string_view unit_symbol(const Unit<T,B,P>&) { return unit_symbol<B>(); }
+
+namespace detail
+{
+	// The most characters std::to_chars writes for a T in its shortest form. Compact reps are
+	// written as their compute type.
+	template <typename R, typename T = ComputeType<R>>
+	constexpr std::size_t value_size()
+	{
+		if (std::is_floating_point<T>::value)
+			return std::numeric_limits<T>::max_digits10 + 8;   // sign, point and exponent
+		else
+			return std::numeric_limits<T>::digits10 + 2;
+	}
+}
+
+// A buffer size that holds any formatted U
+template <typename U>
+constexpr std::size_t format_size = detail::value_size<typename U::rep>() + 1 + unit_symbol<typename U::base>().size();
+
+// Format q into [first, last), as std::to_chars formats a number
+template <typename T, typename B, typename P>
+std::to_chars_result format_to(char* first, char* last, const Unit<T,B,P>& q)
+{
+	constexpr std::string_view symbol = unit_symbol<B>();
+	std::to_chars_result r = std::to_chars(first, last, static_cast<ComputeType<T>>(q.value()));
+	if (r.ec != std::errc() || symbol.empty())
+		return r;
+	if (static_cast<std::size_t>(last - r.ptr) <= symbol.size())
+		return std::to_chars_result{ last, std::errc::value_too_large };
+	*r.ptr = ' ';
+	return std::to_chars_result{ std::copy(symbol.begin(), symbol.end(), r.ptr + 1), std::errc() };
+}
+
+// Format q into a buffer of at least format_size<Unit<T,B,P>>, returning the end of the text
+template <typename T, typename B, typename P>
+char* format_to(char* out, const Unit<T,B,P>& q)
+{
+	return format_to(out, out + format_size<Unit<T,B,P>>, q).ptr;
+}
+
+// Streams write the same text as format_to, regardless of the stream's precision
+template <typename T, typename B, typename P>
+std::ostream& operator<<(std::ostream& os, const Unit<T,B,P>& q)
+{
+	char buffer[format_size<Unit<T,B,P>>];
+	return os.write(buffer, format_to(buffer, q) - buffer);
+}
+
+} // sunit
+
+#ifdef __cpp_lib_format
+template <typename T, typename B, typename P>
+struct std::formatter<sunit::Unit<T,B,P>, char> {
+	constexpr auto parse(std::format_parse_context& ctx)
+	{
+		if (ctx.begin() != ctx.end() && *ctx.begin() != '}')
+			throw std::format_error("sunit: units take no format specification");
+		return ctx.begin();
+	}
+
+	template <typename Context>
+	auto format(const sunit::Unit<T,B,P>& q, Context& ctx) const
+	{
+		char buffer[sunit::format_size<sunit::Unit<T,B,P>>];
+		return std::copy(buffer, sunit::format_to(buffer, q), ctx.out());
+	}
+};
+#endif
+
+#ifdef SUNIT_FMT
+template <typename T, typename B, typename P>
+struct fmt::formatter<sunit::Unit<T,B,P>, char> {
+	constexpr auto parse(fmt::format_parse_context& ctx)
+	{
+		if (ctx.begin() != ctx.end() && *ctx.begin() != '}')
+			throw fmt::format_error("sunit: units take no format specification");
+		return ctx.begin();
+	}
+
+	template <typename Context>
+	auto format(const sunit::Unit<T,B,P>& q, Context& ctx) const
+	{
+		char buffer[sunit::format_size<sunit::Unit<T,B,P>>];
+		return std::copy(buffer, sunit::format_to(buffer, q), ctx.out());
+	}
+};
+#endif
+
+#endif // SIMPLEUNIT_UNITFORMAT_H
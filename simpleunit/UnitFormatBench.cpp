@@ -0,0 +1,85 @@
+#include "simpleunit/UnitFormat.h"
+#include <sstream>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Formatting a batch of speeds: the former ostream overloads, writing the value then a fixed
+// suffix, against operator<< and format_to with compile-time symbols
+
+namespace
+{
+	constexpr size_t count = 1024;
+
+	std::vector<m_s> make_values()
+	{
+		std::vector<m_s> values;
+		for (size_t i = 0; i < count; ++i)
+			values.push_back(m_s(float(i) * 0.37f - 100.f));
+		return values;
+	}
+}
+
+static void BM_FormatOstreamSuffix(benchmark::State& state)
+{
+	const auto values = make_values();
+	std::ostringstream os;
+	for (auto _ : state) {
+		os.seekp(0);
+		for (const m_s& v : values)
+			os << v.value() << " m/s" << '\n';
+		benchmark::DoNotOptimize(os.tellp());
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+BENCHMARK(BM_FormatOstreamSuffix);
+
+static void BM_FormatOstream(benchmark::State& state)
+{
+	const auto values = make_values();
+	std::ostringstream os;
+	for (auto _ : state) {
+		os.seekp(0);
+		for (const m_s& v : values)
+			os << v << '\n';
+		benchmark::DoNotOptimize(os.tellp());
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+BENCHMARK(BM_FormatOstream);
+
+static void BM_FormatTo(benchmark::State& state)
+{
+	const auto values = make_values();
+	std::vector<char> buffer(count * (format_size<m_s> + 1));
+	for (auto _ : state) {
+		char* p = buffer.data();
+		for (const m_s& v : values) {
+			p = format_to(p, v);
+			*p++ = '\n';
+		}
+		benchmark::DoNotOptimize(p);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+BENCHMARK(BM_FormatTo);
+
+#ifdef SUNIT_FMT
+static void BM_FormatFmt(benchmark::State& state)
+{
+	const auto values = make_values();
+	std::vector<char> buffer(count * (format_size<m_s> + 1));
+	for (auto _ : state) {
+		char* p = buffer.data();
+		for (const m_s& v : values)
+			p = fmt::format_to(p, "{}\n", v);
+		benchmark::DoNotOptimize(p);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+BENCHMARK(BM_FormatFmt);
+#endif
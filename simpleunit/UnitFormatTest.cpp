@@ -0,0 +1,115 @@
+#include "simpleunit/UnitFormat.h"
+#include "simpleunit/UnitParse.h"
+#include <sstream>
+#include <string>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	template <typename U>
+	string format_string(const U& q)
+	{
+		char buffer[format_size<U>];
+		return string(buffer, format_to(buffer, q));
+	}
+
+	using Kilometers_Hour = Unit<float, Velocity<std::kilo, hour>>;
+	using Grams = Unit<float, Mass<std::milli>>;
+	using Hertz = Unit<float, BaseUnit<Dim<0,-1>>>;
+	using Ratio = Unit<float, BaseUnit<Dim<0>>>;
+	using Odd = Unit<float, BaseRatio<3,7>>;
+	using OddFlux = Unit<float, VolumetricFlux<std::ratio<3,7>, std::ratio<7>>>;
+	using IntMillimeters = Unit<int, Length<std::milli>>;
+}
+
+TEST(UnitFormatTest, Symbols)
+{
+	static_assert(unit_symbol<Meters::base>() == "m", "");
+	static_assert(unit_symbol<Centimeters2::base>() == "cm^2", "");
+	static_assert(unit_symbol<Meters2_Second::base>() == "m^2/s", "");
+	static_assert(unit_symbol<Inches2_Second::base>() == "in^2/s", "");
+	static_assert(unit_symbol<in_hr::base>() == "in/h", "");
+	static_assert(unit_symbol<Kilometers_Hour::base>() == "km/h", "");
+	static_assert(unit_symbol<m_s2::base>() == "m/s^2", "");
+	static_assert(unit_symbol<kgm_s2::base>() == "m*kg/s^2", "");
+	static_assert(unit_symbol<Pascals::base>() == "kg/m/s^2", "");
+	static_assert(unit_symbol<Grams::base>() == "g", "");
+	static_assert(unit_symbol<Minutes::base>() == "min", "");
+	static_assert(unit_symbol<Milliamperes::base>() == "mA", "");
+	static_assert(unit_symbol<Hertz::base>() == "s^-1", "");
+	static_assert(unit_symbol<Ratio::base>() == "", "");
+
+	// Ratios without a symbol are written out
+	static_assert(unit_symbol<Odd::base>() == "(3/7 m)", "");
+	static_assert(unit_symbol<OddFlux::base>() == "(3/7 m)^2/(7 s)", "");
+
+	EXPECT_EQ("cm^2", unit_symbol(Centimeters2(1)));
+}
+
+TEST(UnitFormatTest, FormatTo)
+{
+	EXPECT_EQ("1.5 m", format_string(Meters(1.5f)));
+	EXPECT_EQ("-0.25 m/s^2", format_string(m_s2(-0.25f)));
+	EXPECT_EQ("101325 kg/m/s^2", format_string(atm));
+	EXPECT_EQ("2500 mm", format_string(IntMillimeters(2500)));
+	EXPECT_EQ("0.5", format_string(Ratio(0.5f)));
+	EXPECT_EQ("-1.1754944e-38 m*kg/s^2", format_string(kgm_s2(-std::numeric_limits<float>::min())));
+	EXPECT_EQ("-2147483648 mm", format_string(IntMillimeters(std::numeric_limits<int>::min())));
+	EXPECT_EQ("-2.2250738585072014e-308 km/h",
+	          format_string(Unit<double, Velocity<std::kilo, hour>>(-std::numeric_limits<double>::min())));
+}
+
+TEST(UnitFormatTest, Bounded)
+{
+	char buffer[8];
+	to_chars_result r = format_to(buffer, buffer + sizeof(buffer), Meters(1.5f));
+	EXPECT_EQ(errc(), r.ec);
+	EXPECT_EQ("1.5 m", string(buffer, r.ptr));
+
+	// No room for the symbol
+	r = format_to(buffer, buffer + 5, m_s(1.5f));
+	EXPECT_EQ(errc::value_too_large, r.ec);
+	EXPECT_EQ(buffer + 5, r.ptr);
+
+	// No room for the value
+	r = format_to(buffer, buffer + 2, Meters(1.5f));
+	EXPECT_EQ(errc::value_too_large, r.ec);
+}
+
+TEST(UnitFormatTest, RoundTrip)
+{
+	EXPECT_FLOAT_EQ(5.4f, parse<Kilometers_Hour>(format_string(Kilometers_Hour(5.4f))).value());
+	EXPECT_FLOAT_EQ(-9.80665f, parse<kgm_s2>(format_string(kgm_s2(-9.80665f))).value());
+	EXPECT_FLOAT_EQ(101325.f, parse<Pascals>(format_string(atm)).value());
+	EXPECT_EQ(2500, parse<IntMillimeters>(format_string(IntMillimeters(2500))).value());
+
+	// Including scales written as ratios
+	EXPECT_FLOAT_EQ(1.25f, parse<Odd>(format_string(Odd(1.25f))).value());
+	EXPECT_FLOAT_EQ(-3.5f, parse<OddFlux>(format_string(OddFlux(-3.5f))).value());
+}
+
+TEST(UnitFormatTest, Stream)
+{
+	ostringstream os;
+	os << Centimeters2(1000) << ", " << in_hr(2) << ", " << Unit<int, BaseUnit<Dim<0>>>(3);
+	EXPECT_EQ("1000 cm^2, 2 in/h, 3", os.str());
+}
+
+#ifdef SUNIT_FMT
+TEST(UnitFormatTest, Fmt)
+{
+	EXPECT_EQ("speed 1.5 m/s", fmt::format("speed {}", m_s(1.5f)));
+	EXPECT_EQ("[2500 mm]", fmt::format("[{}]", IntMillimeters(2500)));
+}
+#endif
+
+#ifdef __cpp_lib_format
+TEST(UnitFormatTest, StdFormat)
+{
+	EXPECT_EQ("speed 1.5 m/s", std::format("speed {}", m_s(1.5f)));
+}
+#endif
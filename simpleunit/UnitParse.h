@@ -0,0 +1,379 @@
+#ifndef SIMPLEUNIT_UNITPARSE_H
+#define SIMPLEUNIT_UNITPARSE_H
+
+#include "simpleunit/UnitArray.h"
+#include "simpleunit/UnitDynamic.h"
+#include "simpleunit/UnitScale.h"
+#include "simpleunit/UnitSymbols.h"
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace sunit {
+
+// Parsing quantities written as text, like "5.2 km/h", into Units.
+//
+// A quantity is a number, optional spaces and a unit expression: symbols from the table in
+// UnitSymbols.h, each with an optional integral exponent (`m^2`, `s^-1`), separated by `*`
+// or `.` to multiply and `/` to divide, e.g. "kg.m/s^2". A symbol may be scaled by a ratio
+// in parentheses, "(1/3 s)", as sunit::format_to writes scales the table doesn't name. A
+// number alone is dimensionless.
+// Numbers are read with std::from_chars, so in the "C" locale and without a leading '+'.
+// Parsing fails if the quantity's dimensions differ from the requested Unit's; otherwise
+// the value is converted to the Unit's scale as unit_cast would convert it.
+//
+//     si::Meters_Second v;
+//     auto result = sunit::parse(first, last, v);         // like std::from_chars
+//     auto speed = sunit::parse<si::m_s>("5.2 km/h");      // or throwing std::invalid_argument
+//
+// `parse_fields` parses a whole buffer of delimited fields, such as a CSV column, and reuses
+// the conversion from one field to the next while their units are written the same.
+
+enum class ParseError {
+	none,
+	number,      // no number where one was expected
+	symbol,      // an unknown symbol or malformed unit expression
+	dimension,   // dimensions that differ from those of the requested unit
+	range        // a value or unit that doesn't fit
+};
+
+struct ParseResult {
+	const char* ptr;      // past the parsed text or, on error, where the error was found
+	ParseError error;
+
+	explicit operator bool() const { return error == ParseError::none; }
+};
+
+// A unit expression, by its dimensions and scale
+struct ParsedUnit {
+	DimCode dim;
+	Scale scale;
+};
+
+namespace detail
+{
+	constexpr bool is_symbol_char(char c)
+	{
+		return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+	}
+
+	// Each exponent of code multiplied by exp, throwing std::overflow_error out of range
+	constexpr DimCode dim_power(DimCode code, int exp)
+	{
+		DimCode result = 0;
+		for (std::size_t i = 0; i < dim_count; ++i) {
+			const int e = dim_exponent(code, i) * exp;
+			if (e < dim_min || e > dim_max)
+				throw std::overflow_error("sunit: dimension exponent out of range");
+			result |= dim_lane(e, i);
+		}
+		return result;
+	}
+
+	inline const char* skip_spaces(const char* first, const char* last)
+	{
+		while (first != last && (*first == ' ' || *first == '\t'))
+			++first;
+		return first;
+	}
+
+	inline const char* trim_spaces(const char* first, const char* last)
+	{
+		while (last != first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+			--last;
+		return last;
+	}
+
+	// Whether c can start a factor of a unit expression
+	constexpr bool starts_factor(char c)
+	{
+		return is_symbol_char(c) || c == '(';
+	}
+
+	// A factor of a unit expression: a symbol, or a symbol scaled by a ratio, "(num/den sym)",
+	// as format_to writes the scales the table has no symbol for
+	inline ParseResult parse_factor(const char* first, const char* last, const UnitSymbol*& symbol, Scale& scale)
+	{
+		const char* p = first;
+		const bool scaled = p != last && *p == '(';
+		scale = Scale{ 1, 1 };
+		if (scaled) {
+			auto r = std::from_chars(p + 1, last, scale.num);
+			if (r.ec == std::errc() && scale.num > 0 && r.ptr != last && *r.ptr == '/')
+				r = std::from_chars(r.ptr + 1, last, scale.den);
+			if (r.ec == std::errc::result_out_of_range)
+				return ParseResult{ p, ParseError::range };
+			if (r.ec != std::errc() || scale.num <= 0 || scale.den <= 0)
+				return ParseResult{ p, ParseError::symbol };
+			p = skip_spaces(r.ptr, last);
+		}
+
+		const char* s = p;
+		while (p != last && is_symbol_char(*p))
+			++p;
+		symbol = find_symbol(std::string_view(s, static_cast<std::size_t>(p - s)));
+		if (!symbol)
+			return ParseResult{ s, ParseError::symbol };
+		if (scaled) {
+			if (p == last || *p != ')')
+				return ParseResult{ p, ParseError::symbol };
+			++p;
+		}
+		return ParseResult{ p, ParseError::none };
+	}
+
+	// The value v, in a unit of scale s with respect to unit ratios, in units of U
+	template <typename U, typename T = typename U::rep>
+	bool convert_parsed(T v, Scale conversion, U& value)
+	{
+		if constexpr (std::is_floating_point<T>::value) {
+			value = U(scale_value<T>(v, conversion));
+			return true;
+		}
+		else {
+			bool overflow = false;
+			const T result = scale_mul_div(v, conversion.num, conversion.den, overflow);
+			if (overflow)
+				return false;
+			value = U(result);
+			return true;
+		}
+	}
+
+	// The ratio from a parsed unit to base B, or an error if the dimensions differ
+	template <typename B>
+	ParseResult parsed_conversion(const char* ptr, const ParsedUnit& unit, Scale& conversion)
+	{
+		if (unit.dim != B::dim::code)
+			return ParseResult{ ptr, ParseError::dimension };
+		constexpr Scale base = scale_of_base<B>();
+		try {
+			conversion = scale_divide(unit.scale, base);
+		}
+		catch (const std::overflow_error&) {
+			return ParseResult{ ptr, ParseError::range };
+		}
+		return ParseResult{ ptr, ParseError::none };
+	}
+}
+
+// Parse a unit expression from the start of [first, last), stopping at the first character
+// that can't continue it
+inline ParseResult parse_unit(const char* first, const char* last, ParsedUnit& unit)
+{
+	DimCode dim = 0;
+	Scale scale{ 1, 1 };
+	bool divide = false;
+	const char* p = first;
+	for (;;) {
+		const char* s = p;
+		const UnitSymbol* symbol = nullptr;
+		Scale factor;
+		const ParseResult f = detail::parse_factor(p, last, symbol, factor);
+		if (!f)
+			return f;
+		p = f.ptr;
+
+		int exp = 1;
+		if (p != last && *p == '^') {
+			const auto r = std::from_chars(p + 1, last, exp);
+			if (r.ec == std::errc::result_out_of_range)
+				return ParseResult{ s, ParseError::range };
+			if (r.ec != std::errc())
+				return ParseResult{ p, ParseError::symbol };
+			// An exponent beyond 8 either way takes any dimension out of [-8, 7]. Rejecting it
+			// here keeps the negation and multiplications below from overflowing.
+			if (exp < dim_min || exp > -dim_min)
+				return ParseResult{ s, ParseError::range };
+			p = r.ptr;
+		}
+		if (divide)
+			exp = -exp;
+
+		try {
+			const Scale symbol_scale = scale_multiply(factor, symbol->scale);
+			if (exp == 1) {
+				dim = dim_add(dim, symbol->dim);
+				scale = scale_multiply(scale, symbol_scale);
+			}
+			else if (exp == -1) {
+				dim = dim_sub(dim, symbol->dim);
+				scale = scale_divide(scale, symbol_scale);
+			}
+			else {
+				dim = dim_add(dim, detail::dim_power(symbol->dim, exp));
+				scale = scale_multiply(scale, scale_pow(symbol_scale, exp));
+			}
+		}
+		catch (const std::overflow_error&) {
+			return ParseResult{ s, ParseError::range };
+		}
+
+		// A separator continues the expression only if a symbol follows it
+		if (p == last || p + 1 == last || !detail::starts_factor(p[1]) || (*p != '*' && *p != '.' && *p != '/'))
+			break;
+		divide = *p == '/';
+		++p;
+	}
+	unit = ParsedUnit{ dim, scale };
+	return ParseResult{ p, ParseError::none };
+}
+
+// Parse a quantity from the start of [first, last) as a U, as std::from_chars parses a number
+template <typename U>
+ParseResult parse(const char* first, const char* last, U& value)
+{
+	using T = typename U::rep;
+	using B = typename U::base;
+
+	T number;
+	const auto r = std::from_chars(first, last, number);
+	if (r.ec == std::errc::invalid_argument)
+		return ParseResult{ first, ParseError::number };
+	if (r.ec == std::errc::result_out_of_range)
+		return ParseResult{ first, ParseError::range };
+
+	// The unit, if any, may follow spaces, which are otherwise left unparsed
+	const char* p = r.ptr;
+	const char* symbol = detail::skip_spaces(p, last);
+	ParsedUnit unit{ 0, Scale{ 1, 1 } };
+	if (symbol != last && detail::starts_factor(*symbol)) {
+		const ParseResult u = parse_unit(symbol, last, unit);
+		if (!u)
+			return u;
+		p = u.ptr;
+	}
+
+	Scale conversion;
+	const ParseResult c = detail::parsed_conversion<B>(symbol, unit, conversion);
+	if (!c)
+		return c;
+	if (!detail::convert_parsed(number, conversion, value))
+		return ParseResult{ first, ParseError::range };
+	return ParseResult{ p, ParseError::none };
+}
+
+// Parse a quantity of any dimensions from the start of [first, last)
+template <typename T>
+ParseResult parse(const char* first, const char* last, DynamicUnit<T>& value)
+{
+	T number;
+	const auto r = std::from_chars(first, last, number);
+	if (r.ec == std::errc::invalid_argument)
+		return ParseResult{ first, ParseError::number };
+	if (r.ec == std::errc::result_out_of_range)
+		return ParseResult{ first, ParseError::range };
+
+	const char* p = r.ptr;
+	const char* symbol = detail::skip_spaces(p, last);
+	ParsedUnit unit{ 0, Scale{ 1, 1 } };
+	if (symbol != last && detail::starts_factor(*symbol)) {
+		const ParseResult u = parse_unit(symbol, last, unit);
+		if (!u)
+			return u;
+		p = u.ptr;
+	}
+	value = DynamicUnit<T>(number, unit.dim, unit.scale);
+	return ParseResult{ p, ParseError::none };
+}
+
+// Parse all of text, apart from surrounding spaces, as a U
+template <typename U>
+U parse(std::string_view text)
+{
+	const char* first = detail::skip_spaces(text.data(), text.data() + text.size());
+	const char* last = detail::trim_spaces(first, text.data() + text.size());
+	U value(0);
+	const ParseResult r = parse(first, last, value);
+	if (!r || r.ptr != last)
+		throw std::invalid_argument("sunit: can't parse \"" + std::string(text) + "\" as the requested unit");
+	return value;
+}
+
+// Parse each field of [first, last), separated by delimiter, appending the values to out.
+// Spaces around each field are ignored, as is an empty final field. Stops at the first
+// field that doesn't parse, with the result pointing into it.
+template <typename T, typename B, typename P>
+ParseResult parse_fields(const char* first, const char* last, char delimiter, UnitArray<T,B,P>& out)
+{
+	using U = Unit<T,B,P>;
+
+	// The units seen most recently, as written, and their conversions to B, so that a column
+	// mixing a few units parses each only once
+	struct Cached {
+		const char* text;
+		std::size_t size;
+		Scale conversion;
+		T factor;
+		bool converting;
+	};
+	constexpr std::size_t cache_size = 4;
+	Cached cache[cache_size] = {};
+	std::size_t cached = 0, replace = 0;
+
+	const char* p = first;
+	while (p != last) {
+		const char* end = static_cast<const char*>(std::memchr(p, delimiter, static_cast<std::size_t>(last - p)));
+		const char* next = end ? end + 1 : last;
+		if (!end)
+			end = last;
+
+		const char* field = detail::skip_spaces(p, end);
+		const char* field_end = detail::trim_spaces(field, end);
+		if (field == field_end && end == last)
+			break;
+
+		T number;
+		const auto r = std::from_chars(field, field_end, number);
+		if (r.ec == std::errc::invalid_argument)
+			return ParseResult{ field, ParseError::number };
+		if (r.ec == std::errc::result_out_of_range)
+			return ParseResult{ field, ParseError::range };
+
+		const char* symbol = detail::skip_spaces(r.ptr, field_end);
+		const std::size_t size = static_cast<std::size_t>(field_end - symbol);
+		const Cached* unit = nullptr;
+		for (std::size_t i = 0; i < cached && !unit; ++i)
+			if (cache[i].size == size && std::memcmp(symbol, cache[i].text, size) == 0)
+				unit = &cache[i];
+		if (!unit) {
+			ParsedUnit parsed{ 0, Scale{ 1, 1 } };
+			if (size != 0) {
+				const ParseResult u = parse_unit(symbol, field_end, parsed);
+				if (!u)
+					return u;
+				if (u.ptr != field_end)
+					return ParseResult{ u.ptr, ParseError::symbol };
+			}
+			Scale conversion;
+			const ParseResult c = detail::parsed_conversion<B>(symbol, parsed, conversion);
+			if (!c)
+				return c;
+			Cached& entry = cache[cached < cache_size ? cached++ : replace++ % cache_size];
+			entry = Cached{ symbol, size, conversion, scale_value<T>(T(1), conversion), conversion != Scale{ 1, 1 } };
+			unit = &entry;
+		}
+
+		U value(number);
+		if constexpr (std::is_floating_point<T>::value) {
+			if (unit->converting)
+				value = U(number * unit->factor);
+		}
+		else if (unit->converting && !detail::convert_parsed(number, unit->conversion, value)) {
+			return ParseResult{ field, ParseError::range };
+		}
+		out.push_back(value);
+		p = next;
+	}
+	return ParseResult{ last, ParseError::none };
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITPARSE_H
@@ -0,0 +1,99 @@
+#include "simpleunit/UnitParse.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Parsing a comma separated column of speeds, a mix of "12.5 km/h" and "3.25 m/s": a baseline
+// of strtof and matching each suffix by hand, against parsing field by field and in one batch
+
+namespace
+{
+	std::string make_column(size_t n)
+	{
+		std::string text;
+		for (size_t i = 0; i < n; ++i) {
+			text += std::to_string(i % 1000) + "." + std::to_string(i % 7);
+			text += i % 4 == 0 ? " m/s," : " km/h,";
+		}
+		return text;
+	}
+}
+
+static void ParseArgs(benchmark::internal::Benchmark* b)
+{
+	b->Arg(1 << 10)->Arg(1 << 16);
+}
+
+static void BM_ParseStrtof(benchmark::State& state)
+{
+	const std::string text = make_column(state.range(0));
+	ArrayOf<m_s> out;
+	for (auto _ : state) {
+		out.clear();
+		const char* p = text.c_str();
+		while (*p) {
+			char* end;
+			float v = std::strtof(p, &end);
+			while (*end == ' ')
+				++end;
+			if (std::strncmp(end, "km/h", 4) == 0) {
+				v /= 3.6f;
+				end += 4;
+			}
+			else if (std::strncmp(end, "m/s", 3) == 0) {
+				end += 3;
+			}
+			else {
+				state.SkipWithError("bad unit");
+				break;
+			}
+			out.push_back(m_s(v));
+			p = *end == ',' ? end + 1 : end;
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * text.size());
+}
+BENCHMARK(BM_ParseStrtof)->Apply(ParseArgs);
+
+static void BM_Parse(benchmark::State& state)
+{
+	const std::string text = make_column(state.range(0));
+	ArrayOf<m_s> out;
+	for (auto _ : state) {
+		out.clear();
+		const char* p = text.data();
+		const char* last = p + text.size();
+		while (p != last) {
+			m_s v(0);
+			const ParseResult r = parse(p, last, v);
+			if (!r || *r.ptr != ',') {
+				state.SkipWithError("parse failed");
+				break;
+			}
+			out.push_back(v);
+			p = r.ptr + 1;
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * text.size());
+}
+BENCHMARK(BM_Parse)->Apply(ParseArgs);
+
+static void BM_ParseFields(benchmark::State& state)
+{
+	const std::string text = make_column(state.range(0));
+	ArrayOf<m_s> out;
+	for (auto _ : state) {
+		out.clear();
+		if (!parse_fields(text.data(), text.data() + text.size(), ',', out))
+			state.SkipWithError("parse failed");
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * text.size());
+}
+BENCHMARK(BM_ParseFields)->Apply(ParseArgs);
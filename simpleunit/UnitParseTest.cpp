@@ -0,0 +1,203 @@
+#include "simpleunit/UnitParse.h"
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+namespace
+{
+	using Kilometers_Hour = Unit<float, Velocity<std::kilo, hour>>;
+	using IntMillimeters = Unit<int, Length<std::milli>>;
+	using IntMeters = Unit<int, Length<meter>>;
+	using Ratio = Unit<float, BaseUnit<Dim<0>>>;
+
+	template <typename U>
+	ParseResult parse_string(const string& s, U& value)
+	{
+		return parse(s.data(), s.data() + s.size(), value);
+	}
+}
+
+TEST(UnitParseTest, Symbols)
+{
+	static_assert(find_symbol("km")->dim == Dim<1>::code, "");
+	static_assert(find_symbol("km")->scale == Scale{ 1000, 1 }, "");
+	static_assert(find_symbol("min")->dim == Dim<0,1>::code, "");
+	static_assert(find_symbol("Pa")->dim == Pascals::base::dim::code, "");
+	static_assert(find_symbol("mol")->dim == Moles::base::dim::code, "");
+	static_assert(find_symbol("furlong") == nullptr, "");
+	static_assert(find_symbol("") == nullptr, "");
+	static_assert(find_symbol("M") == nullptr, "");
+
+	for (size_t i = 0; i < symbols::size; ++i)
+		EXPECT_EQ(&symbols::table[i], find_symbol(symbols::table[i].symbol));
+}
+
+TEST(UnitParseTest, ParseUnit)
+{
+	const auto unit = [](const char* s) {
+		ParsedUnit u{ 0, Scale{ 1, 1 } };
+		const ParseResult r = parse_unit(s, s + strlen(s), u);
+		EXPECT_TRUE(bool(r)) << s;
+		EXPECT_EQ(s + strlen(s), r.ptr) << s;
+		return u;
+	};
+
+	EXPECT_EQ((Dim<1,-1>::code), unit("km/h").dim);
+	EXPECT_EQ((Scale{ 5, 18 }), unit("km/h").scale);
+	EXPECT_EQ((Dim<1,-2>::code), unit("m/s^2").dim);
+	EXPECT_EQ((Dim<1,-2>::code), unit("m/s/s").dim);
+	EXPECT_EQ((Dim<1,-2,1>::code), unit("kg.m/s^2").dim);
+	EXPECT_EQ((Dim<1,-2,1>::code), unit("kg*m*s^-2").dim);
+	EXPECT_EQ((Dim<2>::code), unit("cm^2").dim);
+	EXPECT_EQ((Scale{ 1, 10000 }), unit("cm^2").scale);
+	EXPECT_EQ((Dim<0>::code), unit("m/m").dim);
+
+	// Symbols scaled by a ratio, as format_to writes scales without a symbol
+	EXPECT_EQ((Scale{ 3, 7 }), unit("(3/7 m)").scale);
+	EXPECT_EQ((Dim<2,-1>::code), unit("(3/7 m)^2/(7 s)").dim);
+	EXPECT_EQ((Scale{ 9, 343 }), unit("(3/7 m)^2/(7 s)").scale);
+	EXPECT_EQ((Scale{ 3000, 1 }), unit("(3 km)").scale);
+
+	ParsedUnit u{ 0, Scale{ 1, 1 } };
+	const char* s = "km/hour";
+	EXPECT_EQ(ParseError::symbol, parse_unit(s, s + strlen(s), u).error);
+	EXPECT_EQ(s + 3, parse_unit(s, s + strlen(s), u).ptr);
+
+	// A trailing separator isn't part of the expression
+	s = "m/ and more";
+	EXPECT_TRUE(bool(parse_unit(s, s + strlen(s), u)));
+	EXPECT_EQ(s + 1, parse_unit(s, s + strlen(s), u).ptr);
+
+	s = "m^9";
+	EXPECT_EQ(ParseError::range, parse_unit(s, s + strlen(s), u).error);
+	// Exponents far out of range, without overflowing on the way
+	for (const char* big : { "m^-2147483648", "m^2147483647", "s/m^-2147483648", "m^99999999999", "m^-9" }) {
+		EXPECT_EQ(ParseError::range, parse_unit(big, big + strlen(big), u).error) << big;
+		EXPECT_EQ(strrchr(big, 'm'), parse_unit(big, big + strlen(big), u).ptr) << big;
+	}
+	s = "Hz^8";
+	ASSERT_TRUE(bool(parse_unit(s, s + strlen(s), u)));
+	EXPECT_EQ((Dim<0,-8>::code), u.dim);
+	s = "m^";
+	EXPECT_EQ(ParseError::symbol, parse_unit(s, s + strlen(s), u).error);
+	s = "(3/7 m";
+	EXPECT_EQ(ParseError::symbol, parse_unit(s, s + strlen(s), u).error);
+	s = "(0 m)";
+	EXPECT_EQ(ParseError::symbol, parse_unit(s, s + strlen(s), u).error);
+	s = "(99999999999999999999 m)";
+	EXPECT_EQ(ParseError::range, parse_unit(s, s + strlen(s), u).error);
+}
+
+TEST(UnitParseTest, Parse)
+{
+	m_s v(0);
+	string s = "5.4 km/h";
+	ParseResult r = parse_string(s, v);
+	EXPECT_TRUE(bool(r));
+	EXPECT_EQ(s.data() + s.size(), r.ptr);
+	EXPECT_FLOAT_EQ(1.5f, v.value());
+
+	EXPECT_FLOAT_EQ(5.4f, parse<Kilometers_Hour>("5.4 km/h").value());
+	EXPECT_FLOAT_EQ(2.5f, parse<Meters>("250cm").value());
+	EXPECT_FLOAT_EQ(39.f, parse<Inches>("  1 m ").value());
+	EXPECT_FLOAT_EQ(-9.80665f, parse<m_s2>("-9.80665 m/s^2").value());
+	EXPECT_FLOAT_EQ(101325.f, parse<Pascals>("101.325 kPa").value());
+	EXPECT_FLOAT_EQ(1.5e-3f, parse<Amperes>("1.5 mA").value());
+	EXPECT_FLOAT_EQ(0.5f, parse<Ratio>("0.5").value());
+	EXPECT_FLOAT_EQ(3.f, parse<Ratio>("3 cm/cm").value());
+
+	// The parse stops where the quantity does, as for from_chars
+	s = "12 m, 13 m";
+	Meters m(0);
+	r = parse_string(s, m);
+	EXPECT_TRUE(bool(r));
+	EXPECT_EQ(s.data() + 4, r.ptr);
+	EXPECT_FLOAT_EQ(12.f, m.value());
+
+	s = "12 ";
+	Ratio x(0);
+	EXPECT_EQ(s.data() + 2, parse_string(s, x).ptr);
+}
+
+TEST(UnitParseTest, ParseIntegral)
+{
+	EXPECT_EQ(2500, parse<IntMillimeters>("2500 mm").value());
+	EXPECT_EQ(3000, parse<IntMillimeters>("3 m").value());
+	EXPECT_EQ(2, parse<IntMeters>("2999 mm").value());
+
+	IntMillimeters mm(0);
+	EXPECT_EQ(ParseError::range, parse_string("3000000 m", mm).error);
+	EXPECT_THROW(parse<IntMeters>("2.5 m"), std::invalid_argument);
+}
+
+TEST(UnitParseTest, Errors)
+{
+	Meters m(0);
+	string s = "3 s";
+	ParseResult r = parse_string(s, m);
+	EXPECT_EQ(ParseError::dimension, r.error);
+	EXPECT_EQ(s.data() + 2, r.ptr);
+
+	EXPECT_EQ(ParseError::dimension, parse_string("3", m).error);
+	EXPECT_EQ(ParseError::dimension, parse_string("3 m^2", m).error);
+	EXPECT_EQ(ParseError::number, parse_string("m", m).error);
+	EXPECT_EQ(ParseError::number, parse_string("", m).error);
+	EXPECT_EQ(ParseError::symbol, parse_string("3 furlongs", m).error);
+	EXPECT_EQ(ParseError::range, parse_string("1e999 m", m).error);
+
+	EXPECT_THROW(parse<Meters>("3 s"), std::invalid_argument);
+	EXPECT_THROW(parse<Meters>("3 m extra"), std::invalid_argument);
+	EXPECT_THROW(parse<Meters>("three m"), std::invalid_argument);
+}
+
+TEST(UnitParseTest, ParseFields)
+{
+	const string csv = "1.5 km/h, 3 m/s,-2 m/s ,0 km/h,\n";
+	ArrayOf<m_s> v;
+	ParseResult r = parse_fields(csv.data(), csv.data() + csv.size() - 1, ',', v);
+	EXPECT_TRUE(bool(r));
+	ASSERT_EQ(4u, v.size());
+	EXPECT_FLOAT_EQ(1.5f / 3.6f, v[0].value());
+	EXPECT_FLOAT_EQ(3.f, v[1].value());
+	EXPECT_FLOAT_EQ(-2.f, v[2].value());
+	EXPECT_FLOAT_EQ(0.f, v[3].value());
+
+	const string lines = "5 cm\n6 cm\n7 cm\n1 m\n";
+	ArrayOf<Centimeters> cm;
+	r = parse_fields(lines.data(), lines.data() + lines.size(), '\n', cm);
+	EXPECT_TRUE(bool(r));
+	ASSERT_EQ(4u, cm.size());
+	EXPECT_FLOAT_EQ(7.f, cm[2].value());
+	EXPECT_FLOAT_EQ(100.f, cm[3].value());
+
+	UnitArray<int, Length<std::milli>> mm;
+	const string ints = "1 m;2 mm;3 cm";
+	r = parse_fields(ints.data(), ints.data() + ints.size(), ';', mm);
+	EXPECT_TRUE(bool(r));
+	ASSERT_EQ(3u, mm.size());
+	EXPECT_EQ(1000, mm[0].value());
+	EXPECT_EQ(2, mm[1].value());
+	EXPECT_EQ(30, mm[2].value());
+
+	// Stops at the first bad field, keeping those before it
+	const string bad = "1 m,2 m,3 s,4 m";
+	ArrayOf<Meters> m;
+	r = parse_fields(bad.data(), bad.data() + bad.size(), ',', m);
+	EXPECT_EQ(ParseError::dimension, r.error);
+	EXPECT_EQ(bad.data() + 10, r.ptr);
+	EXPECT_EQ(2u, m.size());
+
+	const string junk = "1 m,2 m x";
+	m.clear();
+	r = parse_fields(junk.data(), junk.data() + junk.size(), ',', m);
+	EXPECT_EQ(ParseError::symbol, r.error);
+
+	const string empty = "1 m,,2 m";
+	m.clear();
+	EXPECT_EQ(ParseError::number, parse_fields(empty.data(), empty.data() + empty.size(), ',', m).error);
+}
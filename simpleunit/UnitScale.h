@@ -0,0 +1,156 @@
+// Outside the guard: Unit.h includes UnitFormat.h, which needs this header whole
+#include "simpleunit/Unit.h"
+
+#ifndef SIMPLEUNIT_UNITSCALE_H
+#define SIMPLEUNIT_UNITSCALE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace sunit {
+
+// Scales known only at runtime, e.g. read from a file or parsed from text, as exact ratios.
+// A `Scale` is the magnitude of a unit with respect to unit ratios in each dimension, so
+// km/h is 1000/3600. Arithmetic on scales is exact and throws std::overflow_error where a
+// result doesn't fit.
+
+struct Scale {
+	std::int64_t num;
+	std::int64_t den;
+};
+
+constexpr bool operator==(const Scale& lhs, const Scale& rhs) { return lhs.num == rhs.num && lhs.den == rhs.den; }
+constexpr bool operator!=(const Scale& lhs, const Scale& rhs) { return !(lhs == rhs); }
+
+namespace detail
+{
+	// a/b * c/d, reducing in 64 bits where the products fit, as they usually do, and otherwise
+	// cancelling common factors across the fractions first, so that only a result that is
+	// itself too large overflows
+	constexpr Scale scale_product(std::int64_t a, std::int64_t b, std::int64_t c, std::int64_t d)
+	{
+		std::int64_t num = 0, den = 0;
+		if (!__builtin_mul_overflow(a, c, &num) && !__builtin_mul_overflow(b, d, &den)) {
+			const std::int64_t g = std::gcd(num, den);
+			return Scale{ num / g, den / g };
+		}
+		const std::int64_t g1 = std::gcd(a, b), g2 = std::gcd(c, d);
+		a /= g1, b /= g1, c /= g2, d /= g2;
+		const std::int64_t g3 = std::gcd(a, d), g4 = std::gcd(c, b);
+		if (__builtin_mul_overflow(a / g3, c / g4, &num) || __builtin_mul_overflow(b / g4, d / g3, &den))
+			throw std::overflow_error("sunit: scale overflows");
+		return Scale{ num, den };
+	}
+}
+
+constexpr Scale scale_multiply(Scale a, Scale b)
+{
+	return detail::scale_product(a.num, a.den, b.num, b.den);
+}
+
+constexpr Scale scale_divide(Scale a, Scale b)
+{
+	return detail::scale_product(a.num, a.den, b.den, b.num);
+}
+
+constexpr Scale scale_pow(Scale a, int exp)
+{
+	Scale result{ 1, 1 };
+	const Scale base = exp < 0 ? Scale{ a.den, a.num } : a;
+	for (int n = exp < 0 ? -exp : exp; n > 0; --n)
+		result = scale_multiply(result, base);
+	return result;
+}
+
+template <typename R>
+constexpr Scale scale_of() { return Scale{ R::num, R::den }; }
+
+namespace detail
+{
+	template <typename B, std::size_t... I>
+	constexpr Scale base_scale(std::index_sequence<I...>)
+	{
+		Scale result{ 1, 1 };
+		((result = scale_multiply(result, scale_pow(scale_of<RatioAt<B,I>>(), dim_exponent(B::dim::code, I)))), ...);
+		return result;
+	}
+}
+
+// The scale of base B: the product of each r^d
+template <typename B>
+constexpr Scale scale_of_base() { return detail::base_scale<B>(DimIndices()); }
+
+namespace detail
+{
+	// y * num / den, truncating as integral division does, with the product in a wider type
+	// where it overflows intmax_t. Sets overflow, and wraps, where the result doesn't fit in Y.
+	template <typename Y>
+	constexpr Y scale_mul_div(Y y, std::int64_t num, std::int64_t den, bool& overflow)
+	{
+		Y result = 0;
+		if (den == 1) {
+			overflow = __builtin_mul_overflow(y, num, &result);
+			return result;
+		}
+		std::intmax_t product = 0;
+		if (!__builtin_mul_overflow(y, num, &product)) {
+			overflow = __builtin_add_overflow(product / den, 0, &result);
+			return result;
+		}
+#if defined(__SIZEOF_INT128__)
+		overflow = __builtin_add_overflow(static_cast<__int128>(y) * num / den, 0, &result);
+#else
+		// (y / den) * num + (y % den) * num / den, exact under truncating division; the
+		// remainder term is less than num, and is found in long double if its product overflows
+		const auto r = y % den;
+		std::intmax_t tail = 0;
+		if (__builtin_mul_overflow(r, num, &tail))
+			tail = static_cast<std::intmax_t>(static_cast<long double>(r) * num / den);
+		else
+			tail /= den;
+		overflow = __builtin_mul_overflow(y / den, num, &result);
+		overflow |= __builtin_add_overflow(result, tail, &result);
+#endif
+		return result;
+	}
+}
+
+// Convert v by scale s, as unit_cast converts by a compile-time ratio. An integral result is
+// exact wherever it fits in Y, however large the intermediate product.
+template <typename Y, typename X>
+constexpr Y scale_value(const X& v, Scale s)
+{
+	using C = ComputeType<Y>;
+	if constexpr (treat_as_floating_point<Y>::value) {
+		return static_cast<Y>(static_cast<C>(v) * static_cast<C>(static_cast<long double>(s.num) / s.den));
+	}
+	else {
+		bool overflow = false;
+		return detail::scale_mul_div(static_cast<Y>(v), s.num, s.den, overflow);
+	}
+}
+
+// Convert v by scale s, clamping (sunit::saturate) or throwing std::overflow_error
+// (sunit::checked) where the result doesn't fit, as unit_cast does with the same tags
+template <typename Y, typename X, typename Policy,
+          typename = std::enable_if_t<std::is_same<Policy,saturate_t>::value || std::is_same<Policy,checked_t>::value>>
+constexpr Y scale_value(const X& v, Scale s, Policy policy)
+{
+	static_assert(std::is_integral<Y>::value, "Saturating and checked conversions require an integral rep");
+
+	const bool negative = (v < 0) != ((s.num < 0) != (s.den < 0));
+	if (!in_range<Y>(v))
+		return on_overflow<Y>(negative, policy);
+
+	bool overflow = false;
+	const Y result = detail::scale_mul_div(static_cast<Y>(v), s.num, s.den, overflow);
+	return overflow ? on_overflow<Y>(negative, policy) : result;
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITSCALE_H
@@ -0,0 +1,57 @@
+#include "simpleunit/UnitScale.h"
+#include <cstdint>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+TEST(UnitScaleTest, Arithmetic)
+{
+	static_assert(scale_multiply(Scale{ 2, 3 }, Scale{ 3, 4 }) == Scale{ 1, 2 }, "");
+	static_assert(scale_divide(Scale{ 1000, 1 }, Scale{ 3600, 1 }) == Scale{ 5, 18 }, "");
+	static_assert(scale_pow(Scale{ 1, 100 }, 2) == Scale{ 1, 10000 }, "");
+	static_assert(scale_pow(Scale{ 1, 100 }, -3) == Scale{ 1000000, 1 }, "");
+	static_assert(scale_pow(Scale{ 7, 3 }, 0) == Scale{ 1, 1 }, "");
+	// The products overflow 64 bits but the reduced result doesn't
+	static_assert(scale_multiply(Scale{ INT64_C(1) << 40, 3 }, Scale{ 9, INT64_C(1) << 41 }) == Scale{ 3, 2 }, "");
+	static_assert(scale_divide(Scale{ INT64_MAX, 2 }, Scale{ INT64_MAX, 4 }) == Scale{ 2, 1 }, "");
+
+	EXPECT_THROW(scale_multiply(Scale{ INT64_MAX, 1 }, Scale{ 2, 1 }), std::overflow_error);
+	EXPECT_THROW(scale_pow(Scale{ 1000, 1 }, 7), std::overflow_error);
+}
+
+TEST(UnitScaleTest, BaseScale)
+{
+	static_assert(scale_of_base<Meters::base>() == Scale{ 1, 1 }, "");
+	static_assert(scale_of_base<Centimeters2::base>() == Scale{ 1, 10000 }, "");
+	static_assert(scale_of_base<in_hr::base>() == Scale{ 1, 39 * 3600 }, "");
+	static_assert(scale_of_base<Milliamperes::base>() == Scale{ 1, 1000 }, "");
+}
+
+TEST(UnitScaleTest, ScaleValue)
+{
+	// As unit_cast converts by the same ratio
+	EXPECT_FLOAT_EQ(unit_cast<Inches>(Centimeters(5)).value(), scale_value<float>(5.f, Scale{ 39, 100 }));
+	EXPECT_EQ((unit_cast<Unit<int, Length<inch>>>(Unit<int, Length<std::centi>>(500)).value()),
+	          scale_value<int>(500, Scale{ 39, 100 }));
+	EXPECT_EQ(3000, scale_value<int>(3, Scale{ 1000, 1 }));
+	EXPECT_DOUBLE_EQ(0.25, scale_value<double>(1, Scale{ 1, 4 }));
+
+	// Exact where the product overflows 64 bits but the result fits
+	EXPECT_EQ(INT64_C(3) << 60, scale_value<std::int64_t>(INT64_C(1) << 62, Scale{ 3, 4 }));
+	EXPECT_EQ(-(INT64_C(3) << 60), scale_value<std::int64_t>(-(INT64_C(1) << 62), Scale{ 3, 4 }));
+	EXPECT_EQ(UINT64_MAX / 3 * 2, scale_value<std::uint64_t>(UINT64_MAX, Scale{ 2, 3 }));
+}
+
+TEST(UnitScaleTest, ScaleValueOverflow)
+{
+	EXPECT_EQ(195, scale_value<int>(500, Scale{ 39, 100 }, checked));
+	EXPECT_EQ(INT32_MAX, scale_value<std::int32_t>(INT32_MAX, Scale{ 3, 2 }, saturate));
+	EXPECT_EQ(INT32_MIN, scale_value<std::int32_t>(INT32_MIN, Scale{ 3, 2 }, saturate));
+	EXPECT_EQ(INT32_MAX, scale_value<std::int32_t>(INT64_C(1) << 40, Scale{ 1, 2 }, saturate));
+	EXPECT_THROW(scale_value<std::int32_t>(INT32_MAX, Scale{ 3, 2 }, checked), std::overflow_error);
+	EXPECT_THROW(scale_value<std::int64_t>(INT64_MAX, Scale{ 1000, 1 }, checked), std::overflow_error);
+	EXPECT_EQ(INT64_MAX / 1000 * 999, scale_value<std::int64_t>(INT64_MAX / 1000 * 1000, Scale{ 999, 1000 }, checked));
+}
@@ -0,0 +1,242 @@
+#ifndef SIMPLEUNIT_UNITSIMD_H
+#define SIMPLEUNIT_UNITSIMD_H
+
+#include "simpleunit/UnitArray.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SUNIT_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SUNIT_SIMD_X86 0
+#endif
+
+namespace sunit {
+
+// Batch conversions over spans of units.
+//
+// For floating-point units the conversion is a single multiply by a factor known at
+// compile time (see `Rescale`), which is broadcast across explicitly vectorised kernels.
+// The widest instruction set supported by the running CPU is chosen once, on first use.
+
+namespace simd {
+
+enum class Isa { scalar, sse2, avx2, avx512 };
+
+inline bool supported(Isa isa)
+{
+#if SUNIT_SIMD_X86
+	switch (isa) {
+	case Isa::scalar: return true;
+	case Isa::sse2:   return __builtin_cpu_supports("sse2");
+	case Isa::avx2:   return __builtin_cpu_supports("avx2");
+	case Isa::avx512: return __builtin_cpu_supports("avx512f");
+	}
+	return false;
+#else
+	return isa == Isa::scalar;
+#endif
+}
+
+inline Isa best_isa()
+{
+	static const Isa isa = supported(Isa::avx512) ? Isa::avx512 :
+	                       supported(Isa::avx2)   ? Isa::avx2 :
+	                       supported(Isa::sse2)   ? Isa::sse2 : Isa::scalar;
+	return isa;
+}
+
+inline const char* name(Isa isa)
+{
+	switch (isa) {
+	case Isa::scalar: return "scalar";
+	case Isa::sse2:   return "sse2";
+	case Isa::avx2:   return "avx2";
+	case Isa::avx512: return "avx512";
+	}
+	return "";
+}
+
+// out[i] = in[i] * factor. `in` and `out` may be the same buffer.
+
+template <typename T>
+inline void scale_scalar(const T* in, T* out, std::size_t n, T factor)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		out[i] = in[i] * factor;
+}
+
+#if SUNIT_SIMD_X86
+
+__attribute__((target("sse2")))
+inline void scale_sse2(const float* in, float* out, std::size_t n, float factor)
+{
+	const __m128 f = _mm_set1_ps(factor);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		_mm_storeu_ps(out + i,     _mm_mul_ps(_mm_loadu_ps(in + i),     f));
+		_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_loadu_ps(in + i + 4), f));
+	}
+	scale_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("sse2")))
+inline void scale_sse2(const double* in, double* out, std::size_t n, double factor)
+{
+	const __m128d f = _mm_set1_pd(factor);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_pd(out + i,     _mm_mul_pd(_mm_loadu_pd(in + i),     f));
+		_mm_storeu_pd(out + i + 2, _mm_mul_pd(_mm_loadu_pd(in + i + 2), f));
+	}
+	scale_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("avx2")))
+inline void scale_avx2(const float* in, float* out, std::size_t n, float factor)
+{
+	const __m256 f = _mm256_set1_ps(factor);
+	std::size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		_mm256_storeu_ps(out + i,     _mm256_mul_ps(_mm256_loadu_ps(in + i),     f));
+		_mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_loadu_ps(in + i + 8), f));
+	}
+	scale_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("avx2")))
+inline void scale_avx2(const double* in, double* out, std::size_t n, double factor)
+{
+	const __m256d f = _mm256_set1_pd(factor);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		_mm256_storeu_pd(out + i,     _mm256_mul_pd(_mm256_loadu_pd(in + i),     f));
+		_mm256_storeu_pd(out + i + 4, _mm256_mul_pd(_mm256_loadu_pd(in + i + 4), f));
+	}
+	scale_scalar(in + i, out + i, n - i, factor);
+}
+
+__attribute__((target("avx512f")))
+inline void scale_avx512(const float* in, float* out, std::size_t n, float factor)
+{
+	const __m512 f = _mm512_set1_ps(factor);
+	std::size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+		_mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_loadu_ps(in + i), f));
+	if (i < n) {
+		// Masked tail, rather than falling back to scalar
+		const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1);
+		_mm512_mask_storeu_ps(out + i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, in + i), f));
+	}
+}
+
+__attribute__((target("avx512f")))
+inline void scale_avx512(const double* in, double* out, std::size_t n, double factor)
+{
+	const __m512d f = _mm512_set1_pd(factor);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(in + i), f));
+	if (i < n) {
+		const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+		_mm512_mask_storeu_pd(out + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, in + i), f));
+	}
+}
+
+#endif
+
+template <typename T>
+using ScaleKernel = void (*)(const T*, T*, std::size_t, T);
+
+// The kernel for isa, or the scalar loop if the CPU doesn't support isa
+template <typename T>
+inline ScaleKernel<T> scale_kernel(Isa isa)
+{
+	if (!supported(isa))
+		return scale_scalar<T>;
+#if SUNIT_SIMD_X86
+	switch (isa) {
+	case Isa::sse2:   return static_cast<ScaleKernel<T>>(scale_sse2);
+	case Isa::avx2:   return static_cast<ScaleKernel<T>>(scale_avx2);
+	case Isa::avx512: return static_cast<ScaleKernel<T>>(scale_avx512);
+	case Isa::scalar: break;
+	}
+#else
+	(void)isa;
+#endif
+	return scale_scalar<T>;
+}
+
+template <typename T>
+inline void scale(const T* in, T* out, std::size_t n, T factor, Isa isa)
+{
+	scale_kernel<T>(isa)(in, out, n, factor);
+}
+
+template <typename T>
+inline void scale(const T* in, T* out, std::size_t n, T factor)
+{
+	static const ScaleKernel<T> kernel = scale_kernel<T>(best_isa());
+	kernel(in, out, n, factor);
+}
+
+} // simd
+
+namespace detail
+{
+	template <typename X, typename Y, typename R>
+	using IsSimdScale = std::integral_constant<bool,
+		std::is_same<std::remove_const_t<X>, Y>::value &&
+		(std::is_same<Y, float>::value || std::is_same<Y, double>::value) &&
+		rescale_kind<Y,R>() == RescaleKind::scale>;
+
+	template <typename R, typename X, typename Y, typename std::enable_if_t<IsSimdScale<X,Y,R>::value, int> = 0>
+	void rescale_n(const X* in, Y* out, std::size_t n)
+	{
+		simd::scale(in, out, n, Rescale<Y,R>::factor());
+	}
+
+	template <typename R, typename X, typename Y, typename std::enable_if_t<!IsSimdScale<X,Y,R>::value, int> = 0>
+	void rescale_n(const X* in, Y* out, std::size_t n)
+	{
+		if (rescale_kind<Y,R>() == RescaleKind::identity && std::is_same<std::remove_const_t<X>, Y>::value) {
+			if (static_cast<const void*>(in) != static_cast<const void*>(out))
+				std::copy(in, in + n, out);
+			return;
+		}
+		for (std::size_t i = 0; i < n; ++i)
+			out[i] = rescale<Y,R>(in[i]);
+	}
+}
+
+// Batch dimension_cast and unit_cast: dst[i] = cast(src[i]) for each element.
+// `dst` must have the size of `src` and may alias it when the reps are equal.
+
+template <typename X, typename B1, typename P1, typename Y, typename B, typename P>
+void dimension_cast(UnitSpan<X,B1,P1> src, UnitSpan<Y,B,P> dst SUNIT_AUDIT_SITE)
+{
+	using R = BaseConversion<B1,B>;
+
+	assert(src.size() == dst.size());
+	SUNIT_AUDIT_CONVERSION(typename decltype(src)::unit_type, typename decltype(dst)::unit_type, R, src.size(), site);
+	detail::rescale_n<R>(src.data(), dst.data(), src.size());
+}
+
+template <typename X, typename B1, typename P1, typename Y, typename B, typename P>
+void unit_cast(UnitSpan<X,B1,P1> src, UnitSpan<Y,B,P> dst SUNIT_AUDIT_SITE)
+{
+	// A unit cast only casts between units of equal dimensions
+	using D = DimAdd<typename B1::dim, typename B::dim>;
+	using R = BaseConversion<B1,B,D>;
+
+	assert(src.size() == dst.size());
+	SUNIT_AUDIT_CONVERSION(typename decltype(src)::unit_type, typename decltype(dst)::unit_type, R, src.size(), site);
+	detail::rescale_n<R>(src.data(), dst.data(), src.size());
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITSIMD_H
@@ -0,0 +1,63 @@
+#include "simpleunit/UnitSimd.h"
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Centimeters -> Inches over arrays from L1-resident (4 KiB) up to DRAM (64 MiB)
+
+static void ConversionArgs(benchmark::internal::Benchmark* b)
+{
+	for (long n = 1 << 10; n <= 1 << 24; n <<= 2)
+		b->Arg(n);
+}
+
+static void BM_UnitCastScalarLoop(benchmark::State& state)
+{
+	ArrayOf<Centimeters> in(state.range(0), Centimeters(1.5f));
+	ArrayOf<Inches> out(in.size());
+	for (auto _ : state) {
+		for (size_t i = 0; i < in.size(); ++i)
+			out[i] = unit_cast<Inches>(in[i]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * 2 * sizeof(float));
+}
+BENCHMARK(BM_UnitCastScalarLoop)->Apply(ConversionArgs);
+
+static void BM_UnitCastBatch(benchmark::State& state, simd::Isa isa)
+{
+	if (!simd::supported(isa)) {
+		state.SkipWithError("instruction set not supported");
+		return;
+	}
+	ArrayOf<Centimeters> in(state.range(0), Centimeters(1.5f));
+	ArrayOf<Inches> out(in.size());
+	const float factor = Rescale<float, BaseConversion<Centimeters::base, Inches::base>>::factor();
+	for (auto _ : state) {
+		simd::scale(in.data(), out.data(), in.size(), factor, isa);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * 2 * sizeof(float));
+}
+BENCHMARK_CAPTURE(BM_UnitCastBatch, scalar, simd::Isa::scalar)->Apply(ConversionArgs);
+BENCHMARK_CAPTURE(BM_UnitCastBatch, sse2, simd::Isa::sse2)->Apply(ConversionArgs);
+BENCHMARK_CAPTURE(BM_UnitCastBatch, avx2, simd::Isa::avx2)->Apply(ConversionArgs);
+BENCHMARK_CAPTURE(BM_UnitCastBatch, avx512, simd::Isa::avx512)->Apply(ConversionArgs);
+
+static void BM_UnitCastBatchDispatch(benchmark::State& state)
+{
+	ArrayOf<Centimeters> in(state.range(0), Centimeters(1.5f));
+	ArrayOf<Inches> out(in.size());
+	for (auto _ : state) {
+		unit_cast(in.span(), out.span());
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetLabel(simd::name(simd::best_isa()));
+	state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * 2 * sizeof(float));
+}
+BENCHMARK(BM_UnitCastBatchDispatch)->Apply(ConversionArgs);
@@ -0,0 +1,74 @@
+#include "simpleunit/UnitSimd.h"
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+TEST(UnitSimdTest, ScaleKernels)
+{
+	// Every kernel agrees with the scalar loop, including the tails. One the CPU doesn't
+	// support is the scalar loop.
+	for (auto isa : { simd::Isa::scalar, simd::Isa::sse2, simd::Isa::avx2, simd::Isa::avx512 }) {
+		if (!simd::supported(isa))
+			EXPECT_EQ(simd::scale_kernel<float>(simd::Isa::scalar), simd::scale_kernel<float>(isa)) << simd::name(isa);
+		for (size_t n : { 0, 1, 3, 15, 16, 17, 33, 100 }) {
+			vector<float> in(n), out(n, -1.f);
+			vector<double> ind(n), outd(n, -1.0);
+			for (size_t i = 0; i < n; ++i)
+				in[i] = ind[i] = 0.5 * i - 3;
+
+			simd::scale(in.data(), out.data(), n, 2.54f, isa);
+			simd::scale(ind.data(), outd.data(), n, 2.54, isa);
+			for (size_t i = 0; i < n; ++i) {
+				EXPECT_EQ(in[i] * 2.54f, out[i]) << simd::name(isa) << " n=" << n << " i=" << i;
+				EXPECT_EQ(ind[i] * 2.54, outd[i]) << simd::name(isa) << " n=" << n << " i=" << i;
+			}
+		}
+	}
+}
+
+TEST(UnitSimdTest, BatchUnitCast)
+{
+	ArrayOf<Centimeters> cm = { Centimeters(0), Centimeters(39), Centimeters(100), Centimeters(-7.8f) };
+	ArrayOf<Inches> in(cm.size());
+	unit_cast(cm.span(), in.span());
+	for (size_t i = 0; i < cm.size(); ++i)
+		EXPECT_FLOAT_EQ(cm[i].asVal<Inches>(), in[i].value());
+
+	// In place, over a raw buffer
+	float raw[] = { 1.f, 2.f, 3.f };
+	unit_cast(unit_span<Meters>(raw, 3), unit_span<Millimeters>(raw, 3));
+	EXPECT_FLOAT_EQ(1000.f, raw[0]);
+	EXPECT_FLOAT_EQ(3000.f, raw[2]);
+
+	// Identity and integral conversions take the scalar path
+	ArrayOf<Meters> m(cm.size());
+	unit_cast(ConstSpanOf<Meters>(unit_span<Meters>(raw, 3)), m.span().first(3));
+	EXPECT_FLOAT_EQ(2000.f, m[1].value());
+
+	UnitArray<int, BaseRatio<4,3>> a = { Unit<int, BaseRatio<4,3>>(7), Unit<int, BaseRatio<4,3>>(-7) };
+	UnitArray<int, BaseRatio<3,2>> a2(2);
+	unit_cast(a.span(), a2.span());
+	EXPECT_EQ(6, a2[0].value());
+	EXPECT_EQ(-6, a2[1].value());
+
+	UnitArray<double, Meters::base> d(3);
+	unit_cast(unit_span<Millimeters>(raw, 3), d.span());
+	EXPECT_DOUBLE_EQ(2.0, d[1].value());
+}
+
+TEST(UnitSimdTest, BatchDimensionCast)
+{
+	float raw[] = { 60.f, 120.f };
+	ArrayOf<Minutes> out(2);
+	dimension_cast(unit_span<Seconds>(raw, 2), out.span());
+	EXPECT_FLOAT_EQ(1.f, out[0].value());
+	EXPECT_FLOAT_EQ(2.f, out[1].value());
+
+	ArrayOf<Meters> m(2);
+	dimension_cast(unit_span<Seconds>(raw, 2), m.span());
+	EXPECT_FLOAT_EQ(60.f, m[0].value());
+	//unit_cast(unit_span<Seconds>(raw, 2), m.span());  // Should not compile: invalid operands 'Dim<0,1,0>' and 'Dim<1,0,0>'
+}
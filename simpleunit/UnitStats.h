@@ -0,0 +1,260 @@
+#ifndef SIMPLEUNIT_UNITSTATS_H
+#define SIMPLEUNIT_UNITSTATS_H
+
+#include "simpleunit/Unit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sunit {
+
+// Streaming statistics of units, in constant memory.
+//
+// `RunningStats<T,B>` keeps the count, mean, variance, least and greatest of the samples added
+// to it by Welford's method. The variance carries the squared dimensions, so the variance of
+// seconds is in square seconds, and the standard deviation is back in seconds.
+//
+// `Histogram<B>` counts samples in log-linear buckets, in the manner of HDR histograms: the
+// value, as a whole number of B, is bucketed by its most significant `Precision` bits, so any
+// value is reported to within a relative error of 2^-Precision. Samples of another scale
+// are rescaled to B at compile time. Recording is a few instructions and never allocates.
+//
+// Both merge, so each thread can record into its own and the results can be combined after.
+//
+//     sunit::Histogram<Time<std::micro>> latency;
+//     latency.record(Unit<double, Time<std::milli>>(1.25));              // 1250 us
+//     auto p99 = latency.quantile(0.99);
+
+template <typename T, typename B, typename P = FinestScale>
+class RunningStats
+{
+	static_assert(treat_as_floating_point<T>::value, "RunningStats accumulates in a floating-point rep");
+
+public:
+	using value_type = Unit<T,B,P>;
+	using square_type = decltype(std::declval<value_type>() * std::declval<value_type>());
+
+	// Add a sample in any unit of the same dimensions
+	template <typename X, typename B1, typename P1>
+	void add(const Unit<X,B1,P1>& u)
+	{
+		static_assert(B1::dim::code == B::dim::code, "RunningStats adds units of its own dimensions");
+		const T x = unit_cast<value_type>(u).value();
+		++n_;
+		const T d = x - mean_;
+		mean_ += d / static_cast<T>(n_);
+		m2_ += d * (x - mean_);
+		min_ = std::min(min_, x);
+		max_ = std::max(max_, x);
+	}
+
+	// Combine with stats of other samples, by Chan et al.'s parallel update
+	void merge(const RunningStats& other)
+	{
+		if (other.n_ == 0)
+			return;
+		if (n_ == 0) {
+			*this = other;
+			return;
+		}
+		const std::uint64_t n = n_ + other.n_;
+		const T d = other.mean_ - mean_;
+		mean_ += d * static_cast<T>(other.n_) / static_cast<T>(n);
+		m2_ += other.m2_ + d * d * static_cast<T>(n_) * static_cast<T>(other.n_) / static_cast<T>(n);
+		min_ = std::min(min_, other.min_);
+		max_ = std::max(max_, other.max_);
+		n_ = n;
+	}
+
+	template <typename X, typename B1, typename P1>
+	RunningStats& operator+=(const Unit<X,B1,P1>& u) { add(u); return *this; }
+
+	RunningStats& operator+=(const RunningStats& other) { merge(other); return *this; }
+
+	std::uint64_t count() const { return n_; }
+	bool empty() const { return n_ == 0; }
+
+	// Zero for no samples
+	value_type mean() const { return value_type(mean_); }
+
+	// Population variance, or zero for no samples
+	square_type variance() const { return square_type(n_ ? m2_ / static_cast<T>(n_) : T(0)); }
+
+	// Sample variance, with Bessel's correction, or zero for fewer than two samples
+	square_type sample_variance() const { return square_type(n_ > 1 ? m2_ / static_cast<T>(n_ - 1) : T(0)); }
+
+	value_type stddev() const { return value_type(std::sqrt(variance().value())); }
+	value_type sample_stddev() const { return value_type(std::sqrt(sample_variance().value())); }
+
+	// Least and greatest samples, or +inf and -inf for no samples
+	value_type min() const { return value_type(min_); }
+	value_type max() const { return value_type(max_); }
+
+	void reset() { *this = RunningStats(); }
+
+private:
+	std::uint64_t n_ = 0;
+	T mean_ = T(0);
+	T m2_ = T(0);
+	T min_ = std::numeric_limits<T>::infinity();
+	T max_ = -std::numeric_limits<T>::infinity();
+};
+
+template <typename B, unsigned Precision = 7>
+class Histogram
+{
+	static_assert(Precision >= 2 && Precision <= 16, "Histogram precision is from 2 to 16 bits");
+
+	static constexpr std::uint64_t sub_buckets = std::uint64_t(1) << Precision;
+	static constexpr std::uint64_t half_buckets = sub_buckets / 2;
+
+public:
+	using value_type = Unit<double,B>;
+
+	// Buckets spanning every whole number of B up to 2^64
+	static constexpr std::size_t bucket_count = (66 - Precision) * half_buckets;
+
+	// The largest relative error of a reported value, against the rounded sample
+	static constexpr double relative_error = 1.0 / sub_buckets;
+
+	Histogram() : counts_(bucket_count, 0) {}
+
+	// Count a sample in any unit of the same dimensions. It is rounded to a whole number of B;
+	// negative samples and NaN count as zero, and samples beyond 2^64 - 1 as 2^64 - 1.
+	template <typename X, typename B1, typename P1>
+	void record(const Unit<X,B1,P1>& u, std::uint64_t count = 1)
+	{
+		static_assert(B1::dim::code == B::dim::code, "Histogram records units of its own dimensions");
+		const std::uint64_t v = whole(u);
+		counts_[index(v)] += count;
+		total_ += count;
+		sum_ += static_cast<double>(v) * count;
+		min_ = std::min(min_, v);
+		max_ = std::max(max_, v);
+	}
+
+	template <typename X, typename B1, typename P1>
+	Histogram& operator+=(const Unit<X,B1,P1>& u) { record(u); return *this; }
+
+	// Add the counts of another histogram
+	void merge(const Histogram& other)
+	{
+		for (std::size_t i = 0; i < bucket_count; ++i)
+			counts_[i] += other.counts_[i];
+		total_ += other.total_;
+		sum_ += other.sum_;
+		min_ = std::min(min_, other.min_);
+		max_ = std::max(max_, other.max_);
+	}
+
+	Histogram& operator+=(const Histogram& other) { merge(other); return *this; }
+
+	std::uint64_t count() const { return total_; }
+	bool empty() const { return total_ == 0; }
+
+	// Exact over the rounded samples, and zero for an empty histogram
+	value_type mean() const { return value_type(total_ ? sum_ / total_ : 0.0); }
+	value_type min() const { return value_type(total_ ? static_cast<double>(min_) : 0.0); }
+	value_type max() const { return value_type(static_cast<double>(max_)); }
+
+	// The value at or below which a fraction q of the samples fall, to within relative_error.
+	// Zero for an empty histogram.
+	value_type quantile(double q) const
+	{
+		if (total_ == 0)
+			return value_type(0.0);
+		const double rank = std::max(1.0, std::ceil(std::min(std::max(q, 0.0), 1.0) * total_));
+		// The first and last samples are known exactly
+		if (rank <= 1)
+			return min();
+		if (rank >= total_)
+			return max();
+		std::uint64_t seen = 0;
+		for (std::size_t i = 0; i < bucket_count; ++i) {
+			seen += counts_[i];
+			if (seen >= rank) {
+				// The middle of the bucket, within what was actually recorded
+				const double mid = static_cast<double>(lowest(i)) + (static_cast<double>(width(i)) - 1) / 2;
+				return value_type(std::min(std::max(mid, static_cast<double>(min_)), static_cast<double>(max_)));
+			}
+		}
+		return max();
+	}
+
+	// Samples counted in the bucket of u
+	template <typename X, typename B1, typename P1>
+	std::uint64_t count_at(const Unit<X,B1,P1>& u) const
+	{
+		return counts_[index(whole(u))];
+	}
+
+	void reset()
+	{
+		std::fill(counts_.begin(), counts_.end(), 0);
+		total_ = 0;
+		sum_ = 0;
+		min_ = std::numeric_limits<std::uint64_t>::max();
+		max_ = 0;
+	}
+
+	// The bucket of a whole number of B
+	static std::size_t index(std::uint64_t v)
+	{
+		if (v < sub_buckets)
+			return static_cast<std::size_t>(v);
+		const unsigned shift = 64 - __builtin_clzll(v) - Precision;
+		return static_cast<std::size_t>(shift * half_buckets + (v >> shift));
+	}
+
+	// The least whole number of B in bucket i, and the number of them
+	static std::uint64_t lowest(std::size_t i)
+	{
+		if (i < sub_buckets)
+			return i;
+		const unsigned shift = static_cast<unsigned>(i / half_buckets) - 1;
+		return (i - shift * half_buckets) << shift;
+	}
+
+	static std::uint64_t width(std::size_t i)
+	{
+		return i < sub_buckets ? 1 : std::uint64_t(1) << (i / half_buckets - 1);
+	}
+
+private:
+	// u as a whole number of B, rescaled in double or std::uint64_t rather than in its own rep,
+	// which the rescale could overflow
+	template <typename X, typename B1, typename P1>
+	static std::uint64_t whole(const Unit<X,B1,P1>& u)
+	{
+		if constexpr (treat_as_floating_point<X>::value) {
+			const double d = unit_cast<Unit<double,B>>(u).value();
+			if (!(d > 0))
+				return 0;
+			if (d >= 18446744073709551615.0)
+				return std::numeric_limits<std::uint64_t>::max();
+			return static_cast<std::uint64_t>(d + 0.5);
+		}
+		else {
+			if (!(u.value() > X(0)))
+				return 0;
+			using Wide = Unit<std::uint64_t,B1>;
+			return unit_cast<Unit<std::uint64_t,B>>(Wide(static_cast<std::uint64_t>(u.value())), saturate).value();
+		}
+	}
+
+	std::vector<std::uint64_t> counts_;
+	std::uint64_t total_ = 0;
+	double sum_ = 0;
+	std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+	std::uint64_t max_ = 0;
+};
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITSTATS_H
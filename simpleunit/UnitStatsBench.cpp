@@ -0,0 +1,89 @@
+#include "simpleunit/UnitStats.h"
+#include <random>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Recording latencies in milliseconds into microsecond stats, against the same updates on raw
+// doubles, and merging per-thread histograms
+
+static std::vector<double> latencies(std::size_t n)
+{
+	std::mt19937 rng(1);
+	std::lognormal_distribution<double> dist(0., 1.);
+	std::vector<double> v(n);
+	for (auto& x : v)
+		x = dist(rng);
+	return v;
+}
+
+static void BM_StatsRaw(benchmark::State& state)
+{
+	const std::vector<double> in = latencies(1 << 12);
+	for (auto _ : state) {
+		std::uint64_t n = 0;
+		double mean = 0, m2 = 0;
+		for (double ms : in) {
+			const double x = ms * 1000;
+			++n;
+			const double d = x - mean;
+			mean += d / n;
+			m2 += d * (x - mean);
+		}
+		benchmark::DoNotOptimize(mean);
+		benchmark::DoNotOptimize(m2);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * (1 << 12));
+}
+BENCHMARK(BM_StatsRaw);
+
+static void BM_StatsRunning(benchmark::State& state)
+{
+	const std::vector<double> in = latencies(1 << 12);
+	for (auto _ : state) {
+		RunningStats<double, Time<std::micro>> s;
+		for (double ms : in)
+			s.add(Unit<double, Time<std::milli>>(ms));
+		benchmark::DoNotOptimize(s);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * (1 << 12));
+}
+BENCHMARK(BM_StatsRunning);
+
+static void BM_HistogramRecord(benchmark::State& state)
+{
+	const std::vector<double> in = latencies(1 << 12);
+	Histogram<Time<std::micro>> h;
+	for (auto _ : state) {
+		for (double ms : in)
+			h.record(Unit<double, Time<std::milli>>(ms));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * (1 << 12));
+}
+BENCHMARK(BM_HistogramRecord);
+
+static void BM_HistogramMerge(benchmark::State& state)
+{
+	Histogram<Time<std::micro>> total, part;
+	for (double ms : latencies(1 << 12))
+		part.record(Unit<double, Time<std::milli>>(ms));
+	for (auto _ : state) {
+		total += part;
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * part.bucket_count * sizeof(std::uint64_t));
+}
+BENCHMARK(BM_HistogramMerge);
+
+static void BM_HistogramQuantile(benchmark::State& state)
+{
+	Histogram<Time<std::micro>> h;
+	for (double ms : latencies(1 << 12))
+		h.record(Unit<double, Time<std::milli>>(ms));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(h.quantile(0.99));
+}
+BENCHMARK(BM_HistogramQuantile);
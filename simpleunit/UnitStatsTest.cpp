@@ -0,0 +1,159 @@
+#include "simpleunit/UnitStats.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+using Millis = Unit<double, Time<milli>>;
+using Micros = Unit<int, Time<micro>>;
+
+TEST(UnitStatsTest, RunningStats)
+{
+	RunningStats<double, Length<meter>> s;
+	EXPECT_TRUE(s.empty());
+	EXPECT_EQ(0., s.mean().value());
+	EXPECT_EQ(0., s.variance().value());
+
+	// Samples of other scales are converted to meters
+	s.add(Meters(2));
+	s += Centimeters(400);
+	s += Millimeters(4000);
+	s.add(Meters(4));
+	s.add(Meters(5));
+	s.add(Meters(5));
+	s.add(Meters(7));
+	s.add(Meters(9));
+	EXPECT_EQ(8u, s.count());
+	EXPECT_DOUBLE_EQ(5., s.mean().value());
+	EXPECT_DOUBLE_EQ(4., s.variance().value());
+	EXPECT_DOUBLE_EQ(2., s.stddev().value());
+	EXPECT_DOUBLE_EQ(32. / 7, s.sample_variance().value());
+	EXPECT_EQ(2., s.min().value());
+	EXPECT_EQ(9., s.max().value());
+
+	// The variance is of square meters
+	auto area = s.variance();
+	static_assert(decltype(area)::base::dim::code == Dim<2>::code, "");
+	EXPECT_DOUBLE_EQ(40000., (unit_cast<Unit<double, Length2<centi>>>(area).value()));
+	static_assert(is_same<decltype(s.stddev()), Unit<double, Length<meter>>>::value, "");
+
+	s.reset();
+	EXPECT_TRUE(s.empty());
+	//s.add(Seconds(1));  // Should not compile: RunningStats adds units of its own dimensions
+}
+
+TEST(UnitStatsTest, RunningStatsMerge)
+{
+	// Stats of the halves, merged, agree with the stats of the whole
+	mt19937 rng(42);
+	normal_distribution<double> dist(20., 3.);
+	RunningStats<double, Time<milli>> all, a, b, empty;
+	for (int i = 0; i < 1000; ++i) {
+		const Millis x(dist(rng));
+		all.add(x);
+		(i % 3 ? a : b).add(x);
+	}
+	a += empty;
+	empty += b;
+	a += empty;
+	EXPECT_EQ(all.count(), a.count());
+	EXPECT_NEAR(all.mean().value(), a.mean().value(), 1e-12);
+	EXPECT_NEAR(all.variance().value(), a.variance().value(), 1e-9);
+	EXPECT_EQ(all.min().value(), a.min().value());
+	EXPECT_EQ(all.max().value(), a.max().value());
+	EXPECT_NEAR(3., a.stddev().value(), 0.3);
+}
+
+TEST(UnitStatsTest, HistogramBuckets)
+{
+	using H = Histogram<Time<micro>, 4>;
+	EXPECT_EQ(62u * 8, H::bucket_count);
+
+	// Buckets are contiguous, and each holds the values from its lowest to the next lowest
+	for (size_t i = 0; i + 1 < H::bucket_count; ++i) {
+		EXPECT_EQ(H::lowest(i) + H::width(i), H::lowest(i + 1)) << i;
+		EXPECT_EQ(i, H::index(H::lowest(i))) << i;
+		EXPECT_EQ(i, H::index(H::lowest(i) + H::width(i) - 1)) << i;
+	}
+	EXPECT_EQ(H::bucket_count - 1, H::index(numeric_limits<uint64_t>::max()));
+	EXPECT_EQ(15u, H::index(15));
+	EXPECT_EQ(16u, H::index(16));
+	EXPECT_EQ(16u, H::index(17));
+	EXPECT_EQ(17u, H::index(18));
+}
+
+TEST(UnitStatsTest, Histogram)
+{
+	Histogram<Time<micro>> h;
+	EXPECT_TRUE(h.empty());
+	EXPECT_EQ(0., h.quantile(0.5).value());
+
+	// Rescaled to microseconds at compile time, and rounded
+	h.record(Millis(1.25));
+	EXPECT_EQ(1u, h.count_at(Micros(1250)));
+	h += Micros(10);
+	h.record(Unit<float, Time<nano>>(20400.f), 2);
+	EXPECT_EQ(4u, h.count());
+	EXPECT_EQ(2u, h.count_at(Micros(20)));
+	EXPECT_EQ(10., h.min().value());
+	EXPECT_EQ(1250., h.max().value());
+	EXPECT_DOUBLE_EQ((1250. + 10 + 40) / 4, h.mean().value());
+
+	// Negative samples and NaN count as zero
+	h.record(Millis(-1));
+	h.record(Millis(std::nan("")));
+	EXPECT_EQ(2u, h.count_at(Micros(0)));
+	EXPECT_EQ(0., h.min().value());
+
+	// Rescaled without overflowing the sample's rep: 3000 s is 3e9 us, beyond int
+	h.record(Unit<int, Time<ratio<1>>>(3000));
+	EXPECT_EQ(1u, h.count_at(Unit<int, Time<ratio<1>>>(3000)));
+	EXPECT_EQ(3e9, h.max().value());
+	h.record(Unit<std::int64_t, Time<ratio<3600>>>(INT64_MAX));
+	EXPECT_EQ(18446744073709551615., h.max().value());
+
+	//h.record(Meters(1));  // Should not compile: Histogram records units of its own dimensions
+}
+
+TEST(UnitStatsTest, HistogramQuantiles)
+{
+	// Uniform from 1 to 100000 us; quantiles are within the relative error of the exact ones
+	Histogram<Time<micro>> h;
+	for (int i = 1; i <= 100000; ++i)
+		h.record(Micros(i));
+	for (double q : { 0.01, 0.25, 0.5, 0.9, 0.99, 0.999 }) {
+		const double exact = std::ceil(q * 100000);
+		EXPECT_NEAR(exact, h.quantile(q).value(), exact * h.relative_error) << q;
+	}
+	EXPECT_EQ(1., h.quantile(0).value());
+	EXPECT_EQ(100000., h.quantile(1).value());
+	static_assert(is_same<decltype(h.quantile(0.5)), Unit<double, Time<micro>>>::value, "");
+	EXPECT_NEAR(100., unit_cast<Millis>(h.quantile(0.001)).value() * 1000, 1.);
+}
+
+TEST(UnitStatsTest, HistogramMerge)
+{
+	Histogram<Time<micro>> all, a, b;
+	mt19937 rng(7);
+	lognormal_distribution<double> dist(5., 1.);
+	for (int i = 0; i < 10000; ++i) {
+		const Micros x(static_cast<int>(dist(rng)));
+		all.record(x);
+		(i % 2 ? a : b).record(x);
+	}
+	a += b;
+	EXPECT_EQ(all.count(), a.count());
+	EXPECT_EQ(all.min().value(), a.min().value());
+	EXPECT_EQ(all.max().value(), a.max().value());
+	EXPECT_DOUBLE_EQ(all.mean().value(), a.mean().value());
+	for (double q : { 0.1, 0.5, 0.99 })
+		EXPECT_EQ(all.quantile(q).value(), a.quantile(q).value()) << q;
+
+	a.reset();
+	EXPECT_TRUE(a.empty());
+	EXPECT_EQ(0u, a.count_at(Micros(100)));
+}
@@ -0,0 +1,41 @@
+// Conversions that StrictScale units reject at compile time. Each SUNIT_STRICT_CASE is compiled
+// on its own by ctest, which expects the StrictScale message from every case but 0.
+#include "simpleunit/UnitArray.h"
+
+using namespace sunit;
+namespace strict = sunit::si::strict;
+
+#ifndef SUNIT_STRICT_CASE
+#define SUNIT_STRICT_CASE 0
+#endif
+
+float check()
+{
+#if SUNIT_STRICT_CASE == 0
+	// Identity conversions and explicit casts compile
+	strict::Meters m = si::Meters(1) + strict::Meters(2);
+	return (m + unit_cast<strict::Meters>(strict::Centimeters(5))).value();
+#elif SUNIT_STRICT_CASE == 1
+	return (strict::Meters(1) + strict::Centimeters(1)).value();
+#elif SUNIT_STRICT_CASE == 2
+	return (strict::Meters(1) - si::Centimeters(1)).value();
+#elif SUNIT_STRICT_CASE == 3
+	strict::Meters m = si::Centimeters(1);
+	return m.value();
+#elif SUNIT_STRICT_CASE == 4
+	si::Centimeters cm = strict::Meters(1);
+	return cm.value();
+#elif SUNIT_STRICT_CASE == 5
+	return (strict::Meters(1) / strict::Centimeters(1)).value();
+#elif SUNIT_STRICT_CASE == 6
+	strict::Seconds t(1);
+	t += strict::Minutes(1);
+	return t.value();
+#elif SUNIT_STRICT_CASE == 7
+	return strict::Meters(si::Centimeters(1)).value();
+#elif SUNIT_STRICT_CASE == 8
+	ArrayOf<strict::Meters> a(4);
+	a.span()[0] = si::Centimeters(150);
+	return a[0].value();
+#endif
+}
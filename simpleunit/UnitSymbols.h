@@ -0,0 +1,98 @@
+// Outside the guard: Unit.h includes UnitFormat.h, which needs this header whole
+#include "simpleunit/UnitScale.h"
+
+#ifndef SIMPLEUNIT_UNITSYMBOLS_H
+#define SIMPLEUNIT_UNITSYMBOLS_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace sunit {
+
+// A compile-time table of unit symbols, each with its dimensions and its scale with respect
+// to unit ratios. Scales follow the ratios of `sunit::si`, so "in" is 1/39 m.
+//
+//     static_assert(find_symbol("km")->dim == Dim<1>::code, "");
+
+struct UnitSymbol {
+	std::string_view symbol;
+	DimCode dim;
+	Scale scale;
+};
+
+namespace symbols {
+
+// Sorted by symbol, for lookup by binary search
+constexpr UnitSymbol table[] = {
+	{ "A",   Dim<0,0,0,1>::code,         { 1, 1 } },
+	{ "Hz",  Dim<0,-1>::code,            { 1, 1 } },
+	{ "J",   Dim<2,-2,1>::code,          { 1, 1 } },
+	{ "K",   Dim<0,0,0,0,1>::code,       { 1, 1 } },
+	{ "L",   Dim<3>::code,               { 1, 1000 } },
+	{ "N",   Dim<1,-2,1>::code,          { 1, 1 } },
+	{ "Pa",  Dim<-1,-2,1>::code,         { 1, 1 } },
+	{ "W",   Dim<2,-3,1>::code,          { 1, 1 } },
+	{ "cd",  Dim<0,0,0,0,0,0,1>::code,   { 1, 1 } },
+	{ "cm",  Dim<1>::code,               { 1, 100 } },
+	{ "d",   Dim<0,1>::code,             { 86400, 1 } },
+	{ "g",   Dim<0,0,1>::code,           { 1, 1000 } },
+	{ "h",   Dim<0,1>::code,             { 3600, 1 } },
+	{ "hr",  Dim<0,1>::code,             { 3600, 1 } },
+	{ "in",  Dim<1>::code,               { 1, 39 } },
+	{ "kA",  Dim<0,0,0,1>::code,         { 1000, 1 } },
+	{ "kHz", Dim<0,-1>::code,            { 1000, 1 } },
+	{ "kJ",  Dim<2,-2,1>::code,          { 1000, 1 } },
+	{ "kN",  Dim<1,-2,1>::code,          { 1000, 1 } },
+	{ "kPa", Dim<-1,-2,1>::code,         { 1000, 1 } },
+	{ "kW",  Dim<2,-3,1>::code,          { 1000, 1 } },
+	{ "kg",  Dim<0,0,1>::code,           { 1, 1 } },
+	{ "km",  Dim<1>::code,               { 1000, 1 } },
+	{ "m",   Dim<1>::code,               { 1, 1 } },
+	{ "mA",  Dim<0,0,0,1>::code,         { 1, 1000 } },
+	{ "mL",  Dim<3>::code,               { 1, 1000000 } },
+	{ "mg",  Dim<0,0,1>::code,           { 1, 1000000 } },
+	{ "min", Dim<0,1>::code,             { 60, 1 } },
+	{ "mm",  Dim<1>::code,               { 1, 1000 } },
+	{ "mol", Dim<0,0,0,0,0,1>::code,     { 1, 1 } },
+	{ "ms",  Dim<0,1>::code,             { 1, 1000 } },
+	{ "ns",  Dim<0,1>::code,             { 1, 1000000000 } },
+	{ "s",   Dim<0,1>::code,             { 1, 1 } },
+	{ "t",   Dim<0,0,1>::code,           { 1000, 1 } },
+	{ "um",  Dim<1>::code,               { 1, 1000000 } },
+	{ "us",  Dim<0,1>::code,             { 1, 1000000 } },
+};
+
+constexpr std::size_t size = sizeof(table) / sizeof(table[0]);
+
+constexpr bool sorted()
+{
+	for (std::size_t i = 1; i < size; ++i)
+		if (!(table[i - 1].symbol < table[i].symbol))
+			return false;
+	return true;
+}
+
+static_assert(sorted(), "The symbol table must be sorted and without duplicates");
+
+} // symbols
+
+// The entry for a symbol, or nullptr if there is none
+constexpr const UnitSymbol* find_symbol(std::string_view symbol)
+{
+	std::size_t first = 0, last = symbols::size;
+	while (first < last) {
+		const std::size_t mid = first + (last - first) / 2;
+		const int c = symbols::table[mid].symbol.compare(symbol);
+		if (c == 0)
+			return &symbols::table[mid];
+		if (c < 0)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+	return nullptr;
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITSYMBOLS_H
@@ -550,3 +550,456 @@ TEST(UnitTest, ReadmeExample)
 	//auto foo = height + Seconds(2);  // Compile error: invalid operands 'Meters' and 'Seconds'
 	auto foo = height / Seconds(2);  // Ok: returns unit of Meters_Second
 }
+
+TEST(UnitTest, Constexpr)
+{
+	using namespace sunit::si;
+
+	// Construction, casts and arithmetic are all usable in constant expressions
+	constexpr Meters height(5);
+	constexpr Centimeters width(200);
+	static_assert(height.value() == 5.f, "");
+	static_assert(height.asVal<Centimeters>() == 500.f, "");
+	static_assert(unit_cast<Centimeters>(height).value() == 500.f, "");
+	static_assert(dimension_cast<Seconds>(height).value() == 5.f, "");
+
+	static_assert((height + width).value() == 700.f, "");
+	static_assert((height - width).value() == 300.f, "");
+	static_assert((height * width).value() == 100000.f, "");
+	static_assert((width / Seconds(2)).value() == 100.f, "");
+	static_assert((height * 2).value() == 10.f, "");
+	static_assert((2 * height).value() == 10.f, "");
+	static_assert((height / 2).value() == 2.5f, "");
+
+	constexpr Unit<int, BaseRatio<4,3>> a(10);
+	constexpr Unit<int, BaseRatio<1,3>> a2(a);
+	static_assert(a2.value() == 40, "");
+
+	constexpr Unit<float, BaseRatio<1,1>> c2(a);
+	EXPECT_FLOAT_EQ(40.f/3, c2.value());
+
+	// Dim arithmetic
+	constexpr auto d = Dim<1,-1>() * Dim<0,1>();
+	static_assert(decltype(d)::d1 == 1 && decltype(d)::d2 == 0, "");
+
+	// Constants
+	static_assert(g.value() == 9.80665f, "");
+	static_assert(c.asVal<Unit<float, Velocity<std::kilo, second>>>() > 299792.f, "");
+	static_assert(atm.value() == 101325.f, "");
+	static_assert(std::is_same<decltype(Kilograms(1) * g)::base::dim, Force<meter, second, kg>::dim>::value, "");
+
+	// Lookup tables built from units
+	constexpr Centimeters table[] = { Meters(1), Meters(2), Inches(39) };
+	static_assert(table[1].value() == 200.f, "");
+	static_assert(table[2].value() == 100.f, "");
+}
+
+// Compound assignment in a constant expression
+constexpr Unit<int, BaseRatio<1,3>> accumulate()
+{
+	Unit<int, BaseRatio<1,3>> total(0);
+	for (int i = 1; i <= 4; ++i)
+		total += Unit<int, BaseRatio<4,3>>(i);
+	total *= 2;
+	return total;
+}
+
+TEST(UnitTest, ConstexprCompoundAssignment)
+{
+	static_assert(accumulate().value() == 80, "");
+	EXPECT_EQ(80, accumulate().value());
+}
+
+TEST(UnitTest, RescaleKind)
+{
+	// The conversion path is chosen at compile time from the rep and the ratio
+	static_assert(rescale_kind<float, ratio<1>>()     == RescaleKind::identity, "");
+	static_assert(rescale_kind<int,   ratio<1>>()     == RescaleKind::identity, "");
+	static_assert(rescale_kind<float, ratio<100>>()   == RescaleKind::scale, "");
+	static_assert(rescale_kind<float, ratio<1,100>>() == RescaleKind::scale, "");
+	static_assert(rescale_kind<int,   ratio<100>>()   == RescaleKind::multiply, "");
+	static_assert(rescale_kind<int,   ratio<1,100>>() == RescaleKind::divide, "");
+	static_assert(rescale_kind<int,   ratio<8,9>>()   == RescaleKind::mul_div, "");
+
+	// Identical bases never rescale, whichever operator is used
+	using si::Meters;
+	using si::Centimeters;
+	static_assert(std::is_same<BaseConversion<Meters::base, Meters::base>, ratio<1>>::value, "");
+	static_assert(std::is_same<BaseConversion<Meters::base, Centimeters::base>, ratio<100>>::value, "");
+
+	// Negative exponents and zero dimensions fold into the one ratio
+	using B1 = BaseUnit<Dim<1,-1>, ratio<1>, ratio<3600>, ratio<4,3>>;
+	using B2 = BaseUnit<Dim<1,-1>, std::centi, ratio<1>>;
+	static_assert(std::is_same<BaseConversion<B1,B2>, ratio<1,36>>::value, "");
+
+	EXPECT_EQ(500, (rescale<int, ratio<100>>(5)));
+	EXPECT_EQ(5, (rescale<int, ratio<1,100>>(500)));
+	EXPECT_EQ(35, (rescale<int, ratio<7,2>>(10)));
+	EXPECT_EQ(1, (rescale<int, ratio<1,100>>(150.f)));  // conversion to Y precedes rescaling
+	EXPECT_FLOAT_EQ(0.7f, (rescale<float, ratio<7,10>>(1)));
+	EXPECT_FLOAT_EQ(4.f, (rescale<float, ratio<1,3>>(12.f)));
+}
+
+TEST(UnitTest, IntegralOverflow)
+{
+	// max(int) * 63 fits in intmax_t, so the product is taken there
+	using R1 = BaseConversion<BaseRatio<7,8>, BaseRatio<8,9>>;
+	static_assert(rescale_kind<int, R1>() == RescaleKind::mul_div, "");
+	Unit<int, BaseRatio<7,8>> a(2000000000);
+	EXPECT_EQ(1968750000, (unit_cast<Unit<int, BaseRatio<8,9>>>(a).value()));
+	EXPECT_EQ(-1968750000, (unit_cast<Unit<int, BaseRatio<8,9>>>(a * -1).value()));
+
+	// int64_t can't widen, but (den-1) * num fits so the division is split
+	static_assert(rescale_kind<int64_t, R1>() == RescaleKind::mul_div_split, "");
+	Unit<int64_t, BaseRatio<7,8>> b(4000000000000000000);
+	EXPECT_EQ(3937500000000000000, (unit_cast<Unit<int64_t, BaseRatio<8,9>>>(b).value()));
+	EXPECT_EQ(-3937500000000000001, (unit_cast<Unit<int64_t, BaseRatio<8,9>>>(b * -1 - Unit<int64_t, BaseRatio<7,8>>(2)).value()));
+
+	// Otherwise a 128-bit intermediate
+	using R2 = ratio<(1ll << 40) + 1, (1ll << 40)>;
+	static_assert(rescale_kind<int64_t, R2>() == RescaleKind::mul_div_wide, "");
+	EXPECT_EQ((1ll << 60) + (1ll << 20), (rescale<int64_t, R2>(1ll << 60)));
+
+	// Results are unchanged in the common case
+	static_assert(rescale<int, ratio<8,9>>(7) == 6, "");
+	static_assert(rescale<int, ratio<8,9>>(-7) == -6, "");
+}
+
+TEST(UnitTest, SaturatingCast)
+{
+	using Coarse = Unit<int, BaseRatio<1,1>>;
+	using Fine = Unit<int, BaseRatio<1,10>>;
+
+	static_assert(unit_cast<Fine>(Coarse(7), saturate).value() == 70, "");
+	EXPECT_EQ(std::numeric_limits<int>::max(), unit_cast<Fine>(Coarse(300000000), saturate).value());
+	EXPECT_EQ(std::numeric_limits<int>::min(), unit_cast<Fine>(Coarse(-300000000), saturate).value());
+
+	// Narrowing of the rep
+	Unit<int64_t, BaseRatio<1,1>> big(int64_t(1) << 40);
+	EXPECT_EQ(std::numeric_limits<int>::max(), unit_cast<Coarse>(big, saturate).value());
+	EXPECT_EQ(0u, (unit_cast<Unit<unsigned, BaseRatio<1,1>>>(Coarse(-1), saturate).value()));
+	EXPECT_EQ(7, (dimension_cast<Unit<int, BaseUnit<Dim<0,1>>>>(Coarse(7), saturate).value()));
+	EXPECT_EQ(std::numeric_limits<int>::max(), unit_cast<Fine>(Unit<float, BaseRatio<1,1>>(1e10f), saturate).value());
+
+	// Mixed ratios saturate on the quotient term
+	using A = Unit<int, BaseRatio<7,8>>;
+	using B = Unit<int, BaseRatio<8,9>>;
+	EXPECT_EQ(6, unit_cast<B>(A(7), saturate).value());
+	EXPECT_EQ(std::numeric_limits<int>::max(), (unit_cast<Unit<int, BaseRatio<1,9>>>(A(std::numeric_limits<int>::max()), saturate).value()));
+}
+
+TEST(UnitTest, CheckedCast)
+{
+	using Coarse = Unit<int, BaseRatio<1,1>>;
+	using Fine = Unit<int, BaseRatio<1,10>>;
+
+	EXPECT_EQ(70, unit_cast<Fine>(Coarse(7), checked).value());
+	EXPECT_EQ(-70, unit_cast<Fine>(Coarse(-7), checked).value());
+	EXPECT_THROW(unit_cast<Fine>(Coarse(300000000), checked), std::overflow_error);
+	EXPECT_THROW(unit_cast<Coarse>(Unit<int64_t, BaseRatio<1,1>>(int64_t(1) << 40), checked), std::overflow_error);
+	EXPECT_THROW(unit_cast<Coarse>(Unit<float, BaseRatio<1,1>>(std::numeric_limits<float>::quiet_NaN()), checked), std::overflow_error);
+}
+
+TEST(UnitTest, TimeAndMassScales)
+{
+	using namespace si;
+
+	// Each fundamental dimension carries its scale in its own ratio
+	EXPECT_FLOAT_EQ(2.f, Seconds(120).asVal<Minutes>());
+	EXPECT_FLOAT_EQ(90.f, Hours(1.5f).asVal<Minutes>());
+	EXPECT_FLOAT_EQ(1.5f, (Unit<float, Mass<std::milli>>(1500).asVal<Kilograms>()));
+	EXPECT_FLOAT_EQ(60.5f, (Minutes(1) + Seconds(0.5f)).value());
+}
+
+namespace
+{
+	template <typename D1, typename D2, typename = void>
+	struct CanMultiplyDims : std::false_type {};
+
+	template <typename D1, typename D2>
+	struct CanMultiplyDims<D1, D2, decltype(void(D1() * D2()))> : std::true_type {};
+}
+
+TEST(UnitTest, DimEncoding)
+{
+	// Trailing zero exponents don't change the type
+	static_assert(std::is_same<Dim<1>, Dim<1,0,0,0,0,0,0>>::value, "");
+	static_assert(!std::is_same<Dim<1>, Dim<0,1>>::value, "");
+	static_assert(Dim<1,-2,3,-4,5,-6,7>::d7 == 7 && Dim<1,-2,3,-4,5,-6,7>::d6 == -6, "");
+	static_assert(Dim<0,0,0,0,0,0,-8>::d7 == -8, "");
+
+	static_assert(std::is_same<decltype(Dim<1,-1>() * Dim<0,1,2,0,0,0,-3>()), Dim<1,0,2,0,0,0,-3>>::value, "");
+	static_assert(std::is_same<DimMultiply<Dim<1,2,3>, Dim<-1,-2,-3>>, Dim<0>>::value, "");
+	static_assert(std::is_same<DimDivide<Dim<0,0,0,1>, Dim<0,1>>, Dim<0,-1,0,1>>::value, "");
+
+	// Exponents beyond [-8, 7] don't compile
+	static_assert(CanMultiplyDims<Dim<4>, Dim<3>>::value, "");
+	static_assert(!CanMultiplyDims<Dim<4>, Dim<4>>::value, "");
+	static_assert(!CanMultiplyDims<Dim<0,0,0,0,0,0,-5>, Dim<0,0,0,0,0,0,-4>>::value, "");
+
+	// The lane-wise arithmetic agrees with per-dimension arithmetic, in every lane
+	for (int i = 0; i < dim_count; ++i) {
+		for (int a = dim_min; a <= dim_max; ++a) {
+			for (int b = dim_min; b <= dim_max; ++b) {
+				// Neighbouring lanes hold values that would expose any carry or borrow
+				const DimCode below = i ? dim_lane(-1, i - 1) : 0;
+				const DimCode ca = dim_lane(a, i) | below | (i + 1 < dim_count ? dim_lane(7, i + 1) : 0);
+				const DimCode cb = dim_lane(b, i) | (i + 1 < dim_count ? dim_lane(-7, i + 1) : 0);
+				const DimCode cs = dim_lane(b, i) | (i + 1 < dim_count ? dim_lane(7, i + 1) : 0);
+				if (a + b >= dim_min && a + b <= dim_max) {
+					EXPECT_EQ(a + b, dim_exponent(dim_add(ca, cb), i));
+					EXPECT_EQ(0, dim_exponent(dim_add(ca, cb), i + 1));
+				}
+				else {
+					EXPECT_THROW(dim_add(ca, cb), std::overflow_error);
+				}
+				if (a - b >= dim_min && a - b <= dim_max) {
+					EXPECT_EQ(a - b, dim_exponent(dim_sub(ca, cs), i));
+					EXPECT_EQ(0, dim_exponent(dim_sub(ca, cs), i + 1));
+					if (i) {
+						EXPECT_EQ(-1, dim_exponent(dim_sub(ca, cs), i - 1));
+					}
+				}
+				else {
+					EXPECT_THROW(dim_sub(ca, cs), std::overflow_error);
+				}
+			}
+		}
+	}
+}
+
+TEST(UnitTest, SevenDimensions)
+{
+	using namespace si;
+
+	// Charge, as current * time
+	auto q = Milliamperes(1500) * Hours(2);
+	using Q = decltype(q)::base;
+	static_assert(Q::dim::d2 == 1 && Q::dim::d4 == 1, "");
+	EXPECT_FLOAT_EQ(10800.f, (q.asVal<Unit<float, BaseUnit<Dim<0,1,0,1>>>>()));
+
+	EXPECT_FLOAT_EQ(1.5f, Milliamperes(1500).asVal<Amperes>());
+	EXPECT_FLOAT_EQ(2.f, (Kelvin(1) + Kelvin(1)).value());
+
+	// Molar concentration times volume
+	auto n = Unit<float, BaseUnit<Dim<-3,0,0,0,0,1>>>(2) * Meters3(3);
+	static_assert(std::is_same<decltype(n)::base::dim, Moles::base::dim>::value, "");
+	EXPECT_FLOAT_EQ(6.f, n.value());
+
+	// Luminous intensity, unrelated to the other dimensions
+	static_assert(std::is_same<decltype(Candelas(1) / Candelas(2)), float>::value, "");
+	EXPECT_EQ(7, int(Luminosity<candela>::dim::d7 * 7));
+}
+
+namespace
+{
+	using namespace sunit::literals;
+
+	// Literals are constants, so a table of them needs no initialisation at runtime
+	constexpr si::Meters depths[] = { 5_m, 200_cm, 1.5_m, 3_in };
+	constexpr si::m_s speeds[] = { 9_m_s, 36_in_hr, 0.5_m_s };
+}
+
+TEST(UnitTest, Literals)
+{
+	using namespace sunit::si;
+
+	static_assert(std::is_same<decltype(5_m), Unit<int64_t, Meters::base>>::value, "");
+	static_assert(std::is_same<decltype(5.0_m), Unit<double, Meters::base>>::value, "");
+	static_assert(std::is_same<decltype(9.81_m_s2)::base, m_s2::base>::value, "");
+	static_assert(std::is_same<decltype(1_Pa)::base, Pascals::base>::value, "");
+	static_assert(std::is_same<decltype(2_mA)::base, Milliamperes::base>::value, "");
+	static_assert((5_m).value() == 5, "");
+	static_assert((132_s).value() == 132, "");
+	static_assert(depths[1].value() == 2.f, "");
+
+	EXPECT_FLOAT_EQ(5.f, depths[0].value());
+	EXPECT_FLOAT_EQ(1.5f, depths[2].value());
+	EXPECT_FLOAT_EQ(3.f / 39, depths[3].value());
+	EXPECT_FLOAT_EQ(36.f / 39 / 3600, speeds[1].value());
+
+	// Integer literals convert exactly to finer units
+	Unit<int, Length<std::milli>> mm = 2_m;
+	EXPECT_EQ(2000, mm.value());
+	EXPECT_EQ(700, (5_m + 200_cm).value());      // in cm
+	EXPECT_DOUBLE_EQ(0.5, (1_m / 2.0_s).value());
+	EXPECT_FLOAT_EQ(9.80665f, Meters_Second2(9.80665_m_s2).value());
+	EXPECT_EQ(90, (1.5_h).as<Minutes>().value());
+}
+
+TEST(UnitTest, RefinedDivision)
+{
+	using namespace sunit::si;
+	using IntMeters = Unit<int, Length<meter>>;
+	using IntCentimeters = Unit<int, Length<std::centi>>;
+	using IntMeters_Second = Unit<int, Velocity<meter, second>>;
+	using IntHertz = Unit<int, BaseUnit<Dim<0,-1>>>;
+
+	// Plain division truncates
+	EXPECT_EQ(0, (IntMeters(1) / 2).value());
+
+	constexpr auto half = divide(IntMeters(1), 2, refine<std::centi>);
+	static_assert(std::is_same<decltype(half), const IntCentimeters>::value, "");
+	static_assert(half.value() == 50, "");
+
+	// The coarsest exact decimal refinement
+	constexpr auto tenths = IntMeters(1) / divisor<2>;
+	static_assert(std::is_same<decltype(tenths)::base, Length<std::deci>>::value, "");
+	static_assert(tenths.value() == 5, "");
+	EXPECT_EQ(50, IntCentimeters(tenths).value());
+	EXPECT_EQ(125, (IntMeters(1) / divisor<8>).value());
+	EXPECT_EQ(5, ((IntCentimeters(1) / divisor<2>).as<Unit<int, Length<std::milli>>>().value()));
+
+	// No power of ten is a multiple of 3, so the unit is a third
+	constexpr auto third = IntMeters(2) / divisor<3>;
+	static_assert(std::is_same<decltype(third)::base, Length<std::ratio<1,3>>>::value, "");
+	EXPECT_EQ(2, third.value());
+
+	// The first dimension with exponent 1 or -1 is refined: here length, then time
+	auto v = divide(IntMeters_Second(3), 4, refine<std::centi>);
+	static_assert(std::is_same<decltype(v)::base, Velocity<std::centi, second>>::value, "");
+	EXPECT_EQ(75, v.value());
+
+	auto f = divide(IntHertz(1), 4, refine<std::milli>);
+	static_assert(std::is_same<decltype(f)::base, BaseUnit<Dim<0,-1>, std::ratio<1>, std::kilo>>::value, "");
+	EXPECT_EQ(250, f.value());
+	EXPECT_FLOAT_EQ(0.25f, (Unit<float, BaseUnit<Dim<0,-1>>>(f).value()));
+
+	EXPECT_FLOAT_EQ(0.5f, divide(Meters(1), 2, refine<std::milli>).as<Meters>().value());
+}
+
+TEST(UnitTest, ScalePolicies)
+{
+	using namespace sunit::si;
+	using LeftInches = WithPolicy<Inches, LeftScale>;
+	using RightInches = WithPolicy<Inches, RightScale>;
+	using SIInches = WithPolicy<Inches, SIScale>;
+
+	// The default takes the finest common scale, here 1/3900 m, rescaling both operands
+	static_assert(std::is_same<decltype(Inches(1) + Centimeters(1))::base, Length<std::ratio<1,3900>>>::value, "");
+	static_assert(std::is_same<decltype(Inches(1) + Centimeters(1))::policy, FinestScale>::value, "");
+
+	static_assert(std::is_same<decltype(LeftInches(1) + Centimeters(1)), Unit<float, Length<inch>, LeftScale>>::value, "");
+	static_assert(std::is_same<decltype(Centimeters(1) + LeftInches(1))::base, Length<std::centi>>::value, "");
+	static_assert(std::is_same<decltype(RightInches(1) - Centimeters(1))::base, Length<std::centi>>::value, "");
+	static_assert(std::is_same<decltype(SIInches(1) + Centimeters(1))::base, Length<meter>>::value, "");
+
+	EXPECT_FLOAT_EQ(1.39f, (LeftInches(1) + Centimeters(1)).value());
+	EXPECT_FLOAT_EQ(100.f / 39 + 1, (RightInches(1) + Centimeters(1)).value());
+	EXPECT_FLOAT_EQ(1.f / 39 + 0.01f, (SIInches(1) + Centimeters(1)).value());
+	EXPECT_FLOAT_EQ((Inches(1) + Centimeters(1)).as<Meters>().value(), (LeftInches(1) + Centimeters(1)).as<Meters>().value());
+
+	// In products, each operand keeps the scale of the dimensions only it has
+	using LeftKilometers = Unit<float, Length<std::kilo>, LeftScale>;
+	using Kilometers_Hour = Unit<float, Velocity<std::kilo, hour>, LeftScale>;
+	static_assert(std::is_same<decltype(LeftKilometers(1) / Hours(1)), Kilometers_Hour>::value, "");
+	static_assert(std::is_same<decltype(LeftKilometers(1) * Meters(1))::base, Length2<std::kilo>>::value, "");
+	static_assert(std::is_same<decltype(Kilometers_Hour(1) * Minutes(30))::base::dim, Dim<1>>::value, "");
+	EXPECT_FLOAT_EQ(36.f, (LeftKilometers(36) / Hours(1)).value());
+	EXPECT_FLOAT_EQ(0.5f, (LeftKilometers(1) * Meters(500)).value());
+	EXPECT_FLOAT_EQ(5.f, ((Kilometers_Hour(10) * Minutes(30)).as<Unit<float, Length<std::kilo>>>().value()));
+
+	// Policies carry through scalar arithmetic and conversions
+	static_assert(std::is_same<decltype(LeftInches(1) * 2.f), LeftInches>::value, "");
+	static_assert(std::is_same<decltype(2.f * LeftInches(1) / 2.f), LeftInches>::value, "");
+	EXPECT_FLOAT_EQ(39.f, LeftInches(Meters(1)).value());
+	EXPECT_FLOAT_EQ(1.f, Meters(LeftInches(39)).value());
+	EXPECT_FLOAT_EQ(2.f, LeftInches(1) / Inches(0.5f));
+
+	// Integral reps keep the lossless default
+	using IntMeters = Unit<int, Length<meter>>;
+	using IntCentimeters = Unit<int, Length<std::centi>>;
+	EXPECT_EQ(105, (IntMeters(1) + IntCentimeters(5)).value());
+}
+
+TEST(UnitTest, StrictScale)
+{
+	namespace strict = sunit::si::strict;
+	static_assert(std::is_same<strict::Meters, Strict<si::Meters>>::value, "");
+	static_assert(std::is_same<strict::Meters::policy, StrictScale>::value, "");
+
+	// Operands of the same scales combine, and keep the policy
+	auto sum = strict::Meters(1) + strict::Meters(2);
+	static_assert(std::is_same<decltype(sum), strict::Meters>::value, "");
+	EXPECT_FLOAT_EQ(3.f, sum.value());
+	EXPECT_FLOAT_EQ(1.5f, (strict::Meters(2) - si::Meters(0.5f)).value());
+	static_assert(std::is_same<decltype(strict::Meters(1) + si::Meters(1)), strict::Meters>::value, "");
+
+	// Products need only agree in the dimensions they share
+	static_assert(std::is_same<decltype(strict::Meters(1) / strict::Seconds(1)), strict::m_s>::value, "");
+	static_assert(std::is_same<decltype(strict::Minutes(1) * strict::Meters(1))::base,
+	                           BaseUnit<Dim<1,1>, si::meter, si::minute>>::value, "");
+	EXPECT_FLOAT_EQ(12.f, (strict::m_s(3) * strict::Seconds(4)).value());
+	EXPECT_FLOAT_EQ(6.f, (strict::Meters2(12) / strict::Meters(2)).value());
+	EXPECT_FLOAT_EQ(2.f, strict::Centimeters(4) / strict::Centimeters(2));
+
+	// Conversions of the same scales are implicit, others need unit_cast
+	strict::Meters m = si::Meters(2);
+	si::Meters plain = m;
+	EXPECT_FLOAT_EQ(2.f, plain.value());
+	EXPECT_FLOAT_EQ(200.f, unit_cast<strict::Centimeters>(m).value());
+	EXPECT_FLOAT_EQ(0.5f, (m + unit_cast<strict::Meters>(strict::Centimeters(50))).value() - 2);
+	EXPECT_FLOAT_EQ(2000.f, m.as<si::Millimeters>().value());
+	m += strict::Meters(1);
+	EXPECT_FLOAT_EQ(3.f, m.value());
+
+	// ...and the traits say so, rather than accept a conversion that then fails to compile
+	static_assert(std::is_convertible<si::Meters, strict::Meters>::value, "");
+	static_assert(!std::is_convertible<strict::Centimeters, strict::Meters>::value, "");
+	static_assert(!std::is_convertible<si::Centimeters, strict::Meters>::value, "");
+	static_assert(!std::is_convertible<strict::Meters, si::Centimeters>::value, "");
+
+	// Scalars don't rescale
+	EXPECT_FLOAT_EQ(1.5f, (strict::Meters(3) / 2.f).value());
+
+	//strict::Meters(1) + strict::Centimeters(1);  // Should not compile: the operands differ in scale
+	//strict::Meters(1) + si::Centimeters(1);      // Should not compile: the operands differ in scale
+	//strict::Meters x = si::Centimeters(1);       // Should not compile: implicit rescale to a strict unit
+	//si::Centimeters y = strict::Meters(1);       // Should not compile: implicit rescale of a strict unit
+	//strict::Meters(1) / strict::Centimeters(1);  // Should not compile: the shared length differs in scale
+}
+
+TEST(UnitTest, Chrono)
+{
+	using namespace sunit::si;
+	using namespace std::chrono;
+	using IntSeconds = Unit<long long, Time<second>>;
+	using IntMilliseconds = Unit<long long, Time<std::milli>>;
+
+	// Implicit where no information is lost, in both directions
+	constexpr IntMilliseconds ms = seconds(3);
+	static_assert(ms.value() == 3000, "");
+	constexpr milliseconds d = IntSeconds(2);
+	static_assert(d.count() == 2000, "");
+	Seconds s = milliseconds(1500);
+	EXPECT_FLOAT_EQ(1.5f, s.value());
+	duration<float, std::ratio<60>> m = Seconds(90);
+	EXPECT_FLOAT_EQ(1.5f, m.count());
+	EXPECT_FLOAT_EQ(2.f, Minutes(minutes(2)).value());
+
+	static_assert(std::is_convertible<seconds, IntMilliseconds>::value, "");
+	static_assert(!std::is_convertible<milliseconds, IntSeconds>::value, "");
+	static_assert(!std::is_convertible<IntMilliseconds, seconds>::value, "");
+	static_assert(!std::is_convertible<seconds, Meters>::value, "");
+	static_assert(!std::is_convertible<Meters, seconds>::value, "");
+
+	// Otherwise explicit, truncating as unit_cast does
+	EXPECT_EQ(2, unit_cast<IntSeconds>(milliseconds(2999)).value());
+	EXPECT_EQ(2, duration_cast<seconds>(IntMilliseconds(2999)).count());
+	EXPECT_EQ(90, sunit::duration_cast<seconds>(Minutes(1.5f)).count());
+	static_assert(std::is_same<decltype(to_unit(hours(1))), Unit<hours::rep, Time<hour>>>::value, "");
+
+	// Arithmetic through the common base
+	auto distance = m_s(3) * milliseconds(500);
+	static_assert(std::is_same<decltype(distance)::base::dim, Dim<1>>::value, "");
+	EXPECT_FLOAT_EQ(1.5f, distance.as<Meters>().value());
+	EXPECT_FLOAT_EQ(1.5f, (milliseconds(500) * m_s(3)).as<Meters>().value());
+
+	auto elapsed = Seconds(1) + milliseconds(250);
+	static_assert(std::is_same<decltype(elapsed)::base, Time<std::milli>>::value, "");
+	EXPECT_FLOAT_EQ(1250.f, elapsed.value());
+	EXPECT_FLOAT_EQ(750.f, (Seconds(1) - milliseconds(250)).value());
+	EXPECT_EQ(3250, (seconds(3) + IntMilliseconds(250)).value());
+	EXPECT_FLOAT_EQ(4.f, (Meters(2) / milliseconds(500)).as<m_s>().value());
+	EXPECT_FLOAT_EQ(0.5f, (seconds(1) / Seconds(2)));
+}
@@ -0,0 +1,461 @@
+#ifndef SIMPLEUNIT_UNITVEC_H
+#define SIMPLEUNIT_UNITVEC_H
+
+#include "simpleunit/UnitArray.h"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace sunit {
+
+// Fixed-size vectors of units, such as positions, velocities and forces.
+//
+// `UnitVec<T,B,N>` holds N components of Unit<T,B>. It is aligned to its size where that is a
+// power of two, and a 3-vector is padded to 4 components, with zero in the padding, so that
+// float vectors fill a 128-bit register and the compiler can operate on all lanes at once.
+// Arithmetic combines dimensions as for Unit: a velocity times a time is a length vector,
+// `dot` and `cross` of a force and a length are an energy and a torque, and `norm` keeps the
+// unit of the vector.
+//
+// `UnitVecArray<T,B,N>` stores many vectors as N arrays of components (structure of arrays),
+// and the batch `dot`, `cross`, `norm` and `add_scaled` loop over them element by element, in
+// loops the compiler vectorises.
+//
+//     UnitVec3<si::m_s> v(1.f, 2.f, 2.f);
+//     UnitVec3<si::Meters> x = v * si::Seconds(2);                // (2, 4, 4) m
+//     auto speed = norm(v);                                       // 3 m/s
+
+namespace detail
+{
+	// Storage lanes, and the alignment of N of T in them
+	constexpr std::size_t vec_lanes(std::size_t n) { return n == 3 ? 4 : n; }
+
+	constexpr std::size_t vec_alignment(std::size_t size, std::size_t align)
+	{
+		return (size & (size - 1)) == 0 && size <= 64 ? size : align;
+	}
+}
+
+template <typename T, typename B, std::size_t N, typename P = FinestScale>
+class alignas(detail::vec_alignment(sizeof(T) * detail::vec_lanes(N), alignof(T))) UnitVec
+{
+	static_assert(N >= 2, "UnitVec has at least two components");
+
+public:
+	using rep = T;
+	using base = B;
+	using policy = P;
+	using value_type = Unit<T,B,P>;
+	using size_type = std::size_t;
+
+	// Components in storage, including the zero padding of 3-vectors
+	static constexpr size_type lanes = detail::vec_lanes(N);
+
+	static_assert(sizeof(value_type) == sizeof(T), "Unit<T,B> must have the layout of T");
+
+	// A component, assignable from a Unit<T,B>. Components are stored as T, so a reference to
+	// one is a proxy rather than a value_type&.
+	class reference
+	{
+	public:
+		constexpr reference& operator=(const value_type& u) { *t_ = u.value(); return *this; }
+		constexpr reference& operator=(const reference& r) { *t_ = *r.t_; return *this; }
+		constexpr reference& operator+=(const value_type& u) { *t_ += u.value(); return *this; }
+		constexpr reference& operator-=(const value_type& u) { *t_ -= u.value(); return *this; }
+
+		constexpr operator value_type() const { return value_type(*t_); }
+		constexpr const T& value() const { return *t_; }
+
+	private:
+		friend class UnitVec;
+		constexpr explicit reference(T* t) : t_(t) {}
+
+		T* t_;
+	};
+
+	constexpr UnitVec() : v_{} {}
+
+	// From N components, each converting implicitly to Unit<T,B>
+	template <typename... Us,
+		typename std::enable_if_t<sizeof...(Us) == N && std::conjunction<std::is_convertible<Us, value_type>...>::value, int> = 0>
+	constexpr UnitVec(const Us&... us) : v_{ value_type(us).value()... } {}
+
+	// Between vectors whose components convert implicitly
+	template <typename X, typename B1, typename P1,
+		typename std::enable_if_t<std::is_convertible<Unit<X,B1,P1>, value_type>::value, int> = 0>
+	constexpr UnitVec(const UnitVec<X,B1,N,P1>& other) : v_{}
+	{
+		for (size_type i = 0; i < N; ++i)
+			v_[i] = value_type(other[i]).value();
+	}
+
+	static constexpr size_type size() { return N; }
+
+	T* data() { return v_; }
+	constexpr const T* data() const { return v_; }
+
+	constexpr reference operator[](size_type i) { return reference(v_ + i); }
+	constexpr value_type operator[](size_type i) const { return value_type(v_[i]); }
+
+	constexpr value_type x() const { return value_type(v_[0]); }
+	constexpr value_type y() const { return value_type(v_[1]); }
+	constexpr value_type z() const { static_assert(N >= 3, "UnitVec has no z component"); return value_type(v_[2]); }
+	constexpr value_type w() const { static_assert(N >= 4, "UnitVec has no w component"); return value_type(v_[3]); }
+
+	constexpr UnitVec& operator+=(const UnitVec& rhs)
+	{
+		for (size_type i = 0; i < lanes; ++i)
+			v_[i] += rhs.v_[i];
+		return *this;
+	}
+
+	constexpr UnitVec& operator-=(const UnitVec& rhs)
+	{
+		for (size_type i = 0; i < lanes; ++i)
+			v_[i] -= rhs.v_[i];
+		return *this;
+	}
+
+	// Scaling leaves the padding zero, whatever x is
+	template <typename X>
+	constexpr UnitVec& operator*=(const X& x)
+	{
+		for (size_type i = 0; i < N; ++i)
+			v_[i] *= x;
+		return *this;
+	}
+
+	template <typename X>
+	constexpr UnitVec& operator/=(const X& x)
+	{
+		for (size_type i = 0; i < N; ++i)
+			v_[i] /= x;
+		return *this;
+	}
+
+private:
+	T v_[lanes];
+};
+
+// Vectors of a unit type, e.g. `UnitVec3<si::m_s>`
+template <typename U, std::size_t N> using VecOf = UnitVec<typename U::rep, typename U::base, N, typename U::policy>;
+template <typename U> using UnitVec3 = VecOf<U,3>;
+template <typename U> using UnitVec4 = VecOf<U,4>;
+
+namespace detail
+{
+	// Apply op to each pair of lanes, padding included, into a vector of its result. For sums,
+	// differences and products of two vectors, zero padding stays zero.
+	template <std::size_t N, typename A, typename C, typename Op>
+	constexpr auto lanewise(const A& a, const C& c, Op op)
+	{
+		using U = decltype(op(a[0], c[0]));
+		VecOf<U,N> r;
+		for (std::size_t i = 0; i < r.lanes; ++i)
+			r.data()[i] = op(Unit<typename A::rep, typename A::base, typename A::policy>(a.data()[i]),
+			                 Unit<typename C::rep, typename C::base, typename C::policy>(c.data()[i])).value();
+		return r;
+	}
+
+	// Apply op to each component, into a vector of its result. The padding is left zero, as op
+	// may not map zero to zero, as when scaling by infinity or NaN or dividing by zero.
+	template <std::size_t N, typename A, typename Op>
+	constexpr auto componentwise(const A& a, Op op)
+	{
+		using U = decltype(op(a[0]));
+		VecOf<U,N> r;
+		for (std::size_t i = 0; i < N; ++i)
+			r.data()[i] = op(Unit<typename A::rep, typename A::base, typename A::policy>(a.data()[i])).value();
+		return r;
+	}
+}
+
+// UnitVec + - UnitVec, at the scale Unit + - gives
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr auto operator+(const UnitVec<X,B1,N,P1>& lhs, const UnitVec<Y,B2,N,P2>& rhs)
+{
+	return detail::lanewise<N>(lhs, rhs, [](const auto& a, const auto& b) { return a + b; });
+}
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr auto operator-(const UnitVec<X,B1,N,P1>& lhs, const UnitVec<Y,B2,N,P2>& rhs)
+{
+	return detail::lanewise<N>(lhs, rhs, [](const auto& a, const auto& b) { return a - b; });
+}
+
+template <typename X, typename B, std::size_t N, typename P>
+constexpr UnitVec<X,B,N,P> operator-(const UnitVec<X,B,N,P>& v)
+{
+	UnitVec<X,B,N,P> r;
+	for (std::size_t i = 0; i < r.lanes; ++i)
+		r.data()[i] = -v.data()[i];
+	return r;
+}
+
+// UnitVec * / Unit, combining dimensions
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr auto operator*(const UnitVec<X,B1,N,P1>& v, const Unit<Y,B2,P2>& u)
+{
+	return detail::componentwise<N>(v, [&](const auto& a) { return a * u; });
+}
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr auto operator*(const Unit<Y,B2,P2>& u, const UnitVec<X,B1,N,P1>& v)
+{
+	return detail::componentwise<N>(v, [&](const auto& a) { return u * a; });
+}
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr auto operator/(const UnitVec<X,B1,N,P1>& v, const Unit<Y,B2,P2>& u)
+{
+	return detail::componentwise<N>(v, [&](const auto& a) { return a / u; });
+}
+
+// UnitVec * / scalar
+
+template <typename X, typename Y, typename B, std::size_t N, typename P>
+constexpr auto operator*(const UnitVec<X,B,N,P>& v, const Y& y)
+{
+	return detail::componentwise<N>(v, [&](const auto& a) { return a * y; });
+}
+
+template <typename X, typename Y, typename B, std::size_t N, typename P>
+constexpr auto operator*(const Y& y, const UnitVec<X,B,N,P>& v)
+{
+	return detail::componentwise<N>(v, [&](const auto& a) { return y * a; });
+}
+
+template <typename X, typename Y, typename B, std::size_t N, typename P>
+constexpr auto operator/(const UnitVec<X,B,N,P>& v, const Y& y)
+{
+	return detail::componentwise<N>(v, [&](const auto& a) { return a / y; });
+}
+
+// Equality of the components, compared at the scale of their sum
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr bool operator==(const UnitVec<X,B1,N,P1>& lhs, const UnitVec<Y,B2,N,P2>& rhs)
+{
+	using U = decltype(lhs[0] + rhs[0]);
+	for (std::size_t i = 0; i < N; ++i)
+		if (!(unit_cast<U>(lhs[i]).value() == unit_cast<U>(rhs[i]).value()))
+			return false;
+	return true;
+}
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr bool operator!=(const UnitVec<X,B1,N,P1>& lhs, const UnitVec<Y,B2,N,P2>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+// Dot product, of the dimensions of the product of the components
+
+template <typename X, typename Y, typename B1, typename B2, std::size_t N, typename P1, typename P2>
+constexpr auto dot(const UnitVec<X,B1,N,P1>& a, const UnitVec<Y,B2,N,P2>& b)
+{
+	const auto products = detail::lanewise<N>(a, b, [](const auto& x, const auto& y) { return x * y; });
+	using U = typename std::decay_t<decltype(products)>::value_type;
+	typename U::rep sum = 0;
+	for (std::size_t i = 0; i < N; ++i)
+		sum += products.data()[i];
+	return U(sum);
+}
+
+// Cross product of 3-vectors
+
+template <typename X, typename Y, typename B1, typename B2, typename P1, typename P2>
+constexpr auto cross(const UnitVec<X,B1,3,P1>& a, const UnitVec<Y,B2,3,P2>& b)
+{
+	using U = decltype(a[0] * b[0]);
+	return VecOf<U,3>(a[1] * b[2] - a[2] * b[1],
+	                  a[2] * b[0] - a[0] * b[2],
+	                  a[0] * b[1] - a[1] * b[0]);
+}
+
+// Euclidean length, in the unit of the vector, and its square
+
+template <typename X, typename B, std::size_t N, typename P>
+constexpr auto squared_norm(const UnitVec<X,B,N,P>& v)
+{
+	return dot(v, v);
+}
+
+template <typename X, typename B, std::size_t N, typename P>
+Unit<X,B,P> norm(const UnitVec<X,B,N,P>& v)
+{
+	return Unit<X,B,P>(static_cast<X>(std::sqrt(squared_norm(v).value())));
+}
+
+// N components of `size` units each, stored apart, and viewed in place
+template <typename T, typename B, std::size_t N, typename P = FinestScale>
+class UnitVecSpan
+{
+public:
+	using rep = std::remove_const_t<T>;
+	using base = B;
+	using policy = P;
+	using vec_type = UnitVec<rep,B,N,P>;
+	using component_type = UnitSpan<T,B,P>;
+	using size_type = std::size_t;
+
+	constexpr UnitVecSpan() = default;
+	constexpr UnitVecSpan(const std::array<T*,N>& components, size_type size) : data_(components), size_(size) {}
+
+	// A span of T converts to a span of const T, but never between bases
+	template <typename X,
+		typename std::enable_if_t<std::is_convertible<X(*)[], T(*)[]>::value, int> = 0>
+	UnitVecSpan(const UnitVecSpan<X,B,N,P>& other) : size_(other.size())
+	{
+		for (size_type k = 0; k < N; ++k)
+			data_[k] = other.data(k);
+	}
+
+	constexpr T* data(size_type k) const { return data_[k]; }
+	constexpr component_type component(size_type k) const { return component_type(data_[k], size_); }
+	constexpr size_type size() const { return size_; }
+	constexpr bool empty() const { return size_ == 0; }
+
+	// Gather vector i, and scatter one there
+	vec_type get(size_type i) const
+	{
+		vec_type v;
+		for (size_type k = 0; k < N; ++k)
+			v.data()[k] = data_[k][i];
+		return v;
+	}
+
+	void set(size_type i, const vec_type& v) const
+	{
+		for (size_type k = 0; k < N; ++k)
+			data_[k][i] = v.data()[k];
+	}
+
+	vec_type operator[](size_type i) const { return get(i); }
+
+private:
+	std::array<T*,N> data_ = {};
+	size_type size_ = 0;
+};
+
+template <typename T, typename B, std::size_t N, typename P = FinestScale>
+class UnitVecArray
+{
+public:
+	using rep = T;
+	using base = B;
+	using policy = P;
+	using vec_type = UnitVec<T,B,N,P>;
+	using size_type = std::size_t;
+
+	UnitVecArray() = default;
+	explicit UnitVecArray(size_type size)
+	{
+		for (auto& c : components_)
+			c = UnitArray<T,B,P>(size);
+	}
+
+	size_type size() const { return components_[0].size(); }
+	bool empty() const { return size() == 0; }
+
+	UnitVecSpan<T,B,N,P> span() { return UnitVecSpan<T,B,N,P>(pointers(components_), size()); }
+	UnitVecSpan<const T,B,N,P> span() const { return UnitVecSpan<const T,B,N,P>(pointers(components_), size()); }
+
+	UnitSpan<T,B,P> component(size_type k) { return components_[k].span(); }
+	UnitSpan<const T,B,P> component(size_type k) const { return components_[k].span(); }
+
+	vec_type operator[](size_type i) const { return span()[i]; }
+	void set(size_type i, const vec_type& v) { span().set(i, v); }
+
+private:
+	template <typename A>
+	static auto pointers(A& components)
+	{
+		std::array<decltype(components[0].data()),N> p;
+		for (size_type k = 0; k < N; ++k)
+			p[k] = components[k].data();
+		return p;
+	}
+
+	std::array<UnitArray<T,B,P>,N> components_;
+};
+
+template <typename U, std::size_t N = 3> using VecArrayOf = UnitVecArray<typename U::rep, typename U::base, N, typename U::policy>;
+template <typename U, std::size_t N = 3> using VecSpanOf = UnitVecSpan<typename U::rep, typename U::base, N, typename U::policy>;
+template <typename U, std::size_t N = 3> using ConstVecSpanOf = UnitVecSpan<const typename U::rep, typename U::base, N, typename U::policy>;
+
+// Batch operations over vector spans, element by element. The output is converted to its
+// unit, which must have the dimensions of the result.
+
+template <typename X, typename B1, typename P1, typename Y, typename B2, typename P2, typename Z, typename B, typename P, std::size_t N>
+void dot(UnitVecSpan<X,B1,N,P1> a, UnitVecSpan<Y,B2,N,P2> b, UnitSpan<Z,B,P> out)
+{
+	using UX = Unit<std::remove_const_t<X>,B1,P1>;
+	using UY = Unit<std::remove_const_t<Y>,B2,P2>;
+	using U = decltype(std::declval<UX>() * std::declval<UY>());
+	static_assert(U::base::dim::code == B::dim::code, "dot writes units of the dimensions of the product");
+	assert(a.size() == b.size() && a.size() == out.size());
+	for (std::size_t i = 0; i < out.size(); ++i) {
+		U sum = UX(a.data(0)[i]) * UY(b.data(0)[i]);
+		for (std::size_t k = 1; k < N; ++k)
+			sum += UX(a.data(k)[i]) * UY(b.data(k)[i]);
+		out.data()[i] = unit_cast<Unit<Z,B,P>>(sum).value();
+	}
+}
+
+template <typename X, typename B1, typename P1, typename Y, typename B2, typename P2, typename Z, typename B, typename P>
+void cross(UnitVecSpan<X,B1,3,P1> a, UnitVecSpan<Y,B2,3,P2> b, UnitVecSpan<Z,B,3,P> out)
+{
+	using UX = Unit<std::remove_const_t<X>,B1,P1>;
+	using UY = Unit<std::remove_const_t<Y>,B2,P2>;
+	using U = decltype(std::declval<UX>() * std::declval<UY>());
+	static_assert(U::base::dim::code == B::dim::code, "cross writes units of the dimensions of the product");
+	assert(a.size() == b.size() && a.size() == out.size());
+	for (std::size_t i = 0; i < out.size(); ++i) {
+		const UX a0(a.data(0)[i]), a1(a.data(1)[i]), a2(a.data(2)[i]);
+		const UY b0(b.data(0)[i]), b1(b.data(1)[i]), b2(b.data(2)[i]);
+		out.data(0)[i] = unit_cast<Unit<Z,B,P>>(a1 * b2 - a2 * b1).value();
+		out.data(1)[i] = unit_cast<Unit<Z,B,P>>(a2 * b0 - a0 * b2).value();
+		out.data(2)[i] = unit_cast<Unit<Z,B,P>>(a0 * b1 - a1 * b0).value();
+	}
+}
+
+template <typename X, typename B1, typename P1, typename Z, typename B, typename P, std::size_t N>
+void norm(UnitVecSpan<X,B1,N,P1> a, UnitSpan<Z,B,P> out)
+{
+	using R = ComputeType<std::remove_const_t<X>>;
+	static_assert(B1::dim::code == B::dim::code, "norm writes units of the dimensions of the vector");
+	assert(a.size() == out.size());
+	for (std::size_t i = 0; i < out.size(); ++i) {
+		R sum = R(0);
+		for (std::size_t k = 0; k < N; ++k)
+			sum += static_cast<R>(a.data(k)[i]) * static_cast<R>(a.data(k)[i]);
+		out.data()[i] = unit_cast<Unit<Z,B,P>>(Unit<R,B1,P1>(static_cast<R>(std::sqrt(sum)))).value();
+	}
+}
+
+// x[i] += v[i] * s, e.g. positions advanced by velocities over a time step
+template <typename Z, typename B, typename P, typename X, typename B1, typename P1, typename Y, typename B2, typename P2, std::size_t N>
+void add_scaled(UnitVecSpan<Z,B,N,P> x, UnitVecSpan<X,B1,N,P1> v, const Unit<Y,B2,P2>& s)
+{
+	using UX = Unit<std::remove_const_t<X>,B1,P1>;
+	using U = decltype(std::declval<UX>() * s);
+	static_assert(U::base::dim::code == B::dim::code, "add_scaled adds units of the dimensions of the product");
+	assert(x.size() == v.size());
+	for (std::size_t k = 0; k < N; ++k) {
+		Z* out = x.data(k);
+		const X* in = v.data(k);
+		for (std::size_t i = 0; i < x.size(); ++i)
+			out[i] += unit_cast<Unit<Z,B,P>>(UX(in[i]) * s).value();
+	}
+}
+
+} // sunit
+
+#endif // SIMPLEUNIT_UNITVEC_H
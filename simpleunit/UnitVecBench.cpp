@@ -0,0 +1,200 @@
+#include "simpleunit/UnitVec.h"
+#include <cmath>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+using namespace sunit;
+using namespace sunit::si;
+
+// Per-particle dot, cross and norm of force and velocity vectors, as raw float[3] against
+// UnitVec3, and over structure-of-arrays storage as raw loops against the batch functions.
+
+static const std::size_t particles = 1 << 12;
+
+using Watts = Unit<float, BaseUnit<Dim<2,-3,1>>>;
+
+struct RawVec { float v[3]; };
+
+static float component(std::size_t i, int k) { return 0.5f + 0.001f * i - 0.3f * k; }
+
+static std::vector<RawVec> raw_vecs()
+{
+	std::vector<RawVec> a(particles);
+	for (std::size_t i = 0; i < particles; ++i)
+		for (int k = 0; k < 3; ++k)
+			a[i].v[k] = component(i, k);
+	return a;
+}
+
+template <typename U>
+static std::vector<UnitVec3<U>> unit_vecs()
+{
+	std::vector<UnitVec3<U>> a(particles);
+	for (std::size_t i = 0; i < particles; ++i)
+		a[i] = UnitVec3<U>(component(i, 0), component(i, 1), component(i, 2));
+	return a;
+}
+
+template <typename U>
+static VecArrayOf<U> unit_soa()
+{
+	VecArrayOf<U> a(particles);
+	for (std::size_t i = 0; i < particles; ++i)
+		a.set(i, UnitVec3<U>(component(i, 0), component(i, 1), component(i, 2)));
+	return a;
+}
+
+static void BM_VecRawDot(benchmark::State& state)
+{
+	const auto f = raw_vecs(), v = raw_vecs();
+	std::vector<float> out(particles);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < particles; ++i)
+			out[i] = f[i].v[0] * v[i].v[0] + f[i].v[1] * v[i].v[1] + f[i].v[2] * v[i].v[2];
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecRawDot);
+
+static void BM_VecUnitDot(benchmark::State& state)
+{
+	const auto f = unit_vecs<kgm_s2>();
+	const auto v = unit_vecs<m_s>();
+	std::vector<Watts> out(particles, Watts(0.f));
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < particles; ++i)
+			out[i] = dot(f[i], v[i]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecUnitDot);
+
+static void BM_VecRawCross(benchmark::State& state)
+{
+	const auto a = raw_vecs(), b = raw_vecs();
+	std::vector<RawVec> out(particles);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < particles; ++i) {
+			out[i].v[0] = a[i].v[1] * b[i].v[2] - a[i].v[2] * b[i].v[1];
+			out[i].v[1] = a[i].v[2] * b[i].v[0] - a[i].v[0] * b[i].v[2];
+			out[i].v[2] = a[i].v[0] * b[i].v[1] - a[i].v[1] * b[i].v[0];
+		}
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecRawCross);
+
+static void BM_VecUnitCross(benchmark::State& state)
+{
+	const auto a = unit_vecs<Meters>();
+	const auto b = unit_vecs<kgm_s2>();
+	std::vector<decltype(cross(a[0], b[0]))> out(particles);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < particles; ++i)
+			out[i] = cross(a[i], b[i]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecUnitCross);
+
+static void BM_VecRawNorm(benchmark::State& state)
+{
+	const auto v = raw_vecs();
+	std::vector<float> out(particles);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < particles; ++i)
+			out[i] = std::sqrt(v[i].v[0] * v[i].v[0] + v[i].v[1] * v[i].v[1] + v[i].v[2] * v[i].v[2]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecRawNorm);
+
+static void BM_VecUnitNorm(benchmark::State& state)
+{
+	const auto v = unit_vecs<m_s>();
+	std::vector<m_s> out(particles, m_s(0.f));
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < particles; ++i)
+			out[i] = norm(v[i]);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecUnitNorm);
+
+static void BM_VecSoARawDot(benchmark::State& state)
+{
+	std::vector<float> f[3], v[3], out(particles);
+	for (int k = 0; k < 3; ++k) {
+		f[k].resize(particles);
+		v[k].resize(particles);
+		for (std::size_t i = 0; i < particles; ++i)
+			f[k][i] = v[k][i] = component(i, k);
+	}
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < particles; ++i)
+			out[i] = f[0][i] * v[0][i] + f[1][i] * v[1][i] + f[2][i] * v[2][i];
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecSoARawDot);
+
+static void BM_VecSoADot(benchmark::State& state)
+{
+	const auto f = unit_soa<kgm_s2>();
+	const auto v = unit_soa<m_s>();
+	ArrayOf<Watts> out(particles);
+	for (auto _ : state) {
+		dot(f.span(), v.span(), out.span());
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecSoADot);
+
+static void BM_VecSoARawIntegrate(benchmark::State& state)
+{
+	std::vector<float> x[3], v[3];
+	for (int k = 0; k < 3; ++k) {
+		x[k].resize(particles);
+		v[k].resize(particles);
+		for (std::size_t i = 0; i < particles; ++i)
+			x[k][i] = v[k][i] = component(i, k);
+	}
+	const float dt = 0.001f;
+	for (auto _ : state) {
+		for (int k = 0; k < 3; ++k)
+			for (std::size_t i = 0; i < particles; ++i)
+				x[k][i] += v[k][i] * dt;
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecSoARawIntegrate);
+
+static void BM_VecSoAIntegrate(benchmark::State& state)
+{
+	auto x = unit_soa<Meters>();
+	const auto v = unit_soa<m_s>();
+	const Unit<float, Time<std::milli>> dt(1);
+	for (auto _ : state) {
+		add_scaled(x.span(), v.span(), dt);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * particles);
+}
+BENCHMARK(BM_VecSoAIntegrate);
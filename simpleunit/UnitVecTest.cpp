@@ -0,0 +1,161 @@
+#include "simpleunit/UnitVec.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace sunit;
+using namespace sunit::si;
+
+TEST(UnitVecTest, Layout)
+{
+	// 3-vectors are padded to 4 lanes and aligned for a 128-bit register
+	EXPECT_EQ(16u, sizeof(UnitVec3<m_s>));
+	EXPECT_EQ(16u, alignof(UnitVec3<m_s>));
+	EXPECT_EQ(16u, sizeof(UnitVec4<Meters>));
+	EXPECT_EQ(32u, alignof(UnitVec<double, Length<meter>, 3>));
+	EXPECT_EQ(8u, alignof(UnitVec<float, Length<meter>, 2>));
+
+	UnitVec3<Meters> v(1.f, 2.f, 3.f);
+	EXPECT_EQ(0.f, v.data()[3]);
+	EXPECT_EQ(2.f, v.y().value());
+	v[1] = Centimeters(50);
+	EXPECT_EQ(0.5f, v[1].value());
+	v[0] += Meters(1);
+	v[2] = v[0];
+	EXPECT_EQ(2.f, Meters(v[2]).value());
+	EXPECT_EQ(3u, v.size());
+}
+
+TEST(UnitVecTest, Arithmetic)
+{
+	const UnitVec3<Meters> a(Meters(1), Centimeters(200), 3.f);
+	const UnitVec3<Centimeters> b(10.f, 20.f, 30.f);
+
+	// Sums take the finer scale, as for Unit
+	auto sum = a + b;
+	static_assert(is_same<decltype(sum), UnitVec3<Centimeters>>::value, "");
+	EXPECT_EQ(UnitVec3<Centimeters>(110.f, 220.f, 330.f), sum);
+	EXPECT_EQ(UnitVec3<Centimeters>(90.f, 180.f, 270.f), a - b);
+	EXPECT_EQ(UnitVec3<Meters>(-1.f, -2.f, -3.f), -a);
+
+	// Implicit conversion between vectors
+	UnitVec3<Centimeters> c = a;
+	EXPECT_EQ(200.f, c.y().value());
+	c += b;
+	c -= UnitVec3<Centimeters>(10.f, 10.f, 10.f);
+	EXPECT_EQ(UnitVec3<Centimeters>(100.f, 210.f, 320.f), c);
+	EXPECT_NE(c, b);
+
+	// Scalars, and units combining dimensions
+	EXPECT_EQ(UnitVec3<Meters>(2.f, 4.f, 6.f), a * 2);
+	EXPECT_EQ(UnitVec3<Meters>(2.f, 4.f, 6.f), 2.f * a);
+	EXPECT_EQ(UnitVec3<Meters>(0.5f, 1.f, 1.5f), a / 2.f);
+
+	const UnitVec3<m_s> v(1.f, 2.f, 2.f);
+	UnitVec3<Meters> x = v * Seconds(2);
+	EXPECT_EQ(UnitVec3<Meters>(2.f, 4.f, 4.f), x);
+	EXPECT_EQ(x, Seconds(2) * v);
+	auto back = x / Seconds(2);
+	static_assert(is_same<decltype(back)::base::dim, m_s::base::dim>::value, "");
+	EXPECT_EQ(v, back);
+	EXPECT_EQ(0.f, back.data()[3]);
+
+	auto scaled = v;
+	scaled *= 3.f;
+	scaled /= 3.f;
+	EXPECT_EQ(v, scaled);
+
+	// Scaling by infinity leaves the padding zero
+	const float inf = numeric_limits<float>::infinity();
+	scaled *= inf;
+	EXPECT_EQ(0.f, scaled.data()[3]);
+	EXPECT_EQ(0.f, (v * inf).data()[3]);
+	EXPECT_EQ(0.f, (v * Seconds(inf)).data()[3]);
+	EXPECT_EQ(0.f, (v / 0.f).data()[3]);
+
+	// Strict components don't rescale, so neither do vectors of them
+	static_assert(is_convertible<UnitVec3<Meters>, UnitVec3<strict::Meters>>::value, "");
+	static_assert(!is_convertible<UnitVec3<strict::Centimeters>, UnitVec3<strict::Meters>>::value, "");
+	static_assert(!is_constructible<UnitVec3<strict::Meters>, UnitVec3<Centimeters>>::value, "");
+	static_assert(!is_constructible<UnitVec3<strict::Meters>, strict::Centimeters, Meters, Meters>::value, "");
+
+	//a + v;  // Should not compile: a length and a velocity don't add
+}
+
+TEST(UnitVecTest, DotCrossNorm)
+{
+	const UnitVec3<kgm_s2> f(0.f, 0.f, 10.f);
+	const UnitVec3<Meters> r(2.f, 0.f, 0.f);
+	const UnitVec3<Centimeters> d(0.f, 0.f, 300.f);
+
+	// Work is force dot distance, torque is distance cross force
+	auto work = dot(f, d);
+	static_assert(decltype(work)::base::dim::code == Dim<2,-2,1>::code, "");
+	EXPECT_FLOAT_EQ(30.f, (unit_cast<Unit<float, BaseUnit<Dim<2,-2,1>>>>(work).value()));
+
+	auto torque = cross(r, f);
+	static_assert(decltype(torque)::base::dim::code == Dim<2,-2,1>::code, "");
+	EXPECT_EQ(-20.f, torque.y().value());
+	EXPECT_EQ(0.f, torque.x().value());
+	EXPECT_EQ(0.f, torque.z().value());
+	EXPECT_EQ(0.f, dot(torque, r).value());
+
+	const UnitVec3<m_s> v(1.f, 2.f, 2.f);
+	auto speed = norm(v);
+	static_assert(is_same<decltype(speed), m_s>::value, "");
+	EXPECT_FLOAT_EQ(3.f, speed.value());
+	EXPECT_FLOAT_EQ(9.f, squared_norm(v).value());
+
+	const UnitVec4<Meters> q(1.f, 1.f, 1.f, 1.f);
+	EXPECT_FLOAT_EQ(2.f, norm(q).value());
+	EXPECT_EQ(1.f, q.w().value());
+}
+
+TEST(UnitVecTest, Batch)
+{
+	const size_t n = 37;
+	VecArrayOf<m_s> v(n);
+	VecArrayOf<Meters> x(n);
+	VecArrayOf<kgm_s2> f(n);
+	vector<UnitVec3<m_s>> vs(n);
+	vector<UnitVec3<kgm_s2>> fs(n);
+	for (size_t i = 0; i < n; ++i) {
+		vs[i] = UnitVec3<m_s>(0.5f * i, 1.f - i, 2.f);
+		fs[i] = UnitVec3<kgm_s2>(1.f, 0.25f * i, -3.f);
+		v.set(i, vs[i]);
+		f.set(i, fs[i]);
+		x.set(i, UnitVec3<Meters>(float(i), 0.f, 0.f));
+	}
+	EXPECT_EQ(n, v.size());
+	EXPECT_EQ(vs[5], v[5]);
+	EXPECT_EQ(vs[5].y().value(), v.component(1)[5].value());
+
+	// Power is force dot velocity, written here in milliwatts
+	using Milliwatts = Unit<float, BaseUnit<Dim<2,-3,1>, milli>>;
+	ArrayOf<Milliwatts> power(n);
+	dot(f.span(), ConstVecSpanOf<m_s>(v.span()), power.span());
+	for (size_t i = 0; i < n; ++i)
+		EXPECT_FLOAT_EQ(unit_cast<Milliwatts>(dot(fs[i], vs[i])).value(), power[i].value()) << i;
+
+	VecArrayOf<Unit<float, BaseUnit<Dim<2,-3,1>>>> c(n);
+	cross(v.span(), f.span(), c.span());
+	for (size_t i = 0; i < n; ++i)
+		EXPECT_EQ(cross(vs[i], fs[i]), c[i]) << i;
+
+	ArrayOf<Unit<float, Velocity<std::kilo, second>>> speed(n);
+	norm(v.span(), speed.span());
+	for (size_t i = 0; i < n; ++i)
+		EXPECT_FLOAT_EQ(norm(vs[i]).value() / 1000, speed[i].value()) << i;
+
+	// Positions advanced by velocities over a time step
+	add_scaled(x.span(), v.span(), Unit<float, Time<milli>>(500));
+	for (size_t i = 0; i < n; ++i) {
+		const UnitVec3<Meters> expected = UnitVec3<Meters>(float(i), 0.f, 0.f) + vs[i] * Seconds(0.5f);
+		for (size_t k = 0; k < 3; ++k)
+			EXPECT_FLOAT_EQ(expected[k].value(), x[i][k].value()) << i;
+	}
+
+	//add_scaled(x.span(), v.span(), Meters(1));  // Should not compile: the product must be a length
+}